@@ -20,16 +20,22 @@ COLOR_LIGHT_GREY :: sdl.Color{0xcc, 0xcc, 0xcc, 0xff}
 COLOR_WHITE :: sdl.Color{0xff, 0xff, 0xff, 0xff}
 
 FontID :: i32
+PackID :: i32
 Event :: proc "c" (component: rawptr)
+EventHandler :: proc "c" (event: ^sdl.Event, data: rawptr) -> bool
+DrawHandler :: proc "c" (data: rawptr)
+ListViewSource :: proc "c" (row: i32, data: rawptr) -> cstring
 
-ComponentType :: enum {
+ComponentType :: enum i32 {
 	COMPONENT_TEXT,
 	COMPONENT_IMAGE,
 	COMPONENT_BUTTON,
 	COMPONENT_SLIDER,
+	COMPONENT_CONTAINER,
+	COMPONENT_LIST_VIEW,
 }
 
-EventType :: enum {
+EventType :: enum i32 {
 	BUTTON_ON_PRESS,
 	BUTTON_ON_RELEASE,
 	BUTTON_ON_ENTER,
@@ -37,38 +43,287 @@ EventType :: enum {
 	SLIDER_INTERNAL,
 	SLIDER_ON_HOLD,
 	SLIDER_ON_RELEASE,
+	IMAGE_ON_LOAD,
+	IMAGE_ON_FAIL,
+	SLIDER_ON_CHANGE,
+	LIST_VIEW_ON_SELECT,
 }
 
 ComponentNode :: struct {
 	component: rawptr,
 	type: ComponentType,
-	events: ^EventNode,
+	events: [EVENT_BUCKETS]EventList,
+	gridX0, gridY0, gridX1, gridY1: i32,
+	activeIndex: i32,
+	hotIndex: i32,
+
+	x, y: i32,
+	bounds: sdl.Rect,
+	placed: bool,
+
+	hidden: bool,
+	commandDrain: u32,
+	commandMask: u8,
+	numOwners: i32,
+	owner: ^ComponentNode,
+	parent: ^ComponentNode,
 	prev, next: ^ComponentNode,
 }
 
-EventNode :: struct {
-	event: Event,
-	type: EventType,
-	prev, next: ^EventNode,
+EVENT_INLINE_CAPACITY :: 2
+EVENT_BUCKETS :: 4
+
+EventList :: struct {
+	events: [^]Event,
+	count, capacity: i32,
+	inlineEvents: [EVENT_INLINE_CAPACITY]Event,
+}
+
+Pool :: struct {
+	itemSize: uint,
+	itemsPerSlab: i32,
+	slabs: rawptr,
+	freeList: rawptr,
+	numSlabs, numUsed: i32,
+}
+
+GridCell :: struct {
+	items: ^i32,
+	count, capacity: i32,
+
+	packed: ^i32,
+	packedCapacity: i32,
+	stale: bool,
+}
+
+Grid :: struct {
+	cells: ^GridCell,
+	columns, rows, cellSize: i32,
+}
+
+HOT_ON_SCREEN :: 0x01
+HOT_RETAINED :: 0x02
+
+HotStore :: struct {
+	nodes: ^^ComponentNode,
+	x0, y0, x1, y1: ^i32,
+	flags: ^u8,
+	visited: ^u32,
+	count, capacity: i32,
+}
+
+ATLAS_SIZE :: 512
+ATLAS_GLYPHS :: 256
+
+AtlasPage :: struct {
+	texture: ^sdl.Texture,
+	width, height: i32,
+	shelfX, shelfY, shelfHeight: i32,
+	numImages: i32,
+}
+
+Glyph :: struct {
+	rect: sdl.Rect,
+	page, advance: i32,
+	loaded: bool,
+}
+
+GlyphAtlas :: struct {
+	glyphs: [ATLAS_GLYPHS]Glyph,
+	pages: [^]AtlasPage,
+	numPages, height, lineSkip: i32,
+
+	path: cstring,
+	ptsize: i32,
+}
+
+BAKED_FONT_VERSION :: 1
+BAKED_FIRST_GLYPH :: 32
+BAKED_LAST_GLYPH :: 126
+
+TEXT_CACHE_DEFAULT_BUDGET :: 8 * 1024 * 1024
+
+TextCacheEntry :: struct {
+	str: cstring,
+	font: FontID,
+	fg, bg: sdl.Color,
+	shaded: bool,
+	hash: u32,
+
+	texture: ^sdl.Texture,
+	width, height: i32,
+	bytes: uint,
+	refCount: i32,
+
+	hashNext: ^TextCacheEntry,
+	lruPrev, lruNext: ^TextCacheEntry,
+}
+
+TextCache :: struct {
+	buckets: [^]^TextCacheEntry,
+	numBuckets, numEntries: i32,
+	lruHead, lruTail: ^TextCacheEntry,
+	bytes, budget: uint,
+	hits, misses, evictions: i32,
+}
+
+DrawCommand :: struct {
+	texture: ^sdl.Texture,
+	first, count: i32,
+}
+
+DrawList :: struct {
+	commands: [^]DrawCommand,
+	vertices: [^]sdl.Vertex,
+	indices: [^]i32,
+	numCommands, commandsCapacity, numVertices, verticesCapacity, numIndices, indicesCapacity: i32,
+	batching: bool,
 }
 
 Context :: struct {
 	window: ^sdl.Window,
 	render: ^sdl.Renderer,
 	width, height: i32,
-	components: ^ComponentNode,
+	components, componentsTail: ^ComponentNode,
+	componentPool: Pool,
+	registry: ^^ComponentNode,
+	registryCapacity, registryCount: i32,
+	grid: Grid,
+	hot: HotStore,
+	drawn: ^i32,
+	active: ^^ComponentNode,
+	numDrawn, drawnCapacity, numActive, activeCapacity: i32,
+	updateCount: u32,
 	fonts: ^^ttf.Font,
+	atlases: [^]GlyphAtlas,
 	numFonts: i32,
+	textCache: TextCache,
+	drawList: DrawList,
+
+	frame: ^sdl.Texture,
+	frameWidth, frameHeight: i32,
+	dirtyRect: sdl.Rect,
+	dirty, directDraw: bool,
+
+	imagePages: [^]AtlasPage,
+	numImagePages: i32,
+	imageAtlas: bool,
+	loader: ImageLoader,
+	imageCache: ImageCache,
+	packs: [^]Pack,
+	numPacks: i32,
+	commands: CommandQueue,
+	stats: FrameStats,
+	redraw, animating: bool,
+
+	root: ^ComponentNode,
+	layoutRoots: [^]^ComponentNode,
+	numLayoutRoots, layoutRootsCapacity: i32,
+	layoutDirty: bool,
 }
 
 Text :: struct {
 	texture: ^sdl.Texture,
 	width, height: i32,
+	cacheEntry: ^TextCacheEntry,
+
+	str: cstring,
+	font: FontID,
+	fg, bg: sdl.Color,
+	shaded: bool,
+	textureWidth, textureHeight: i32,
 }
 
 Image :: struct {
 	texture: ^sdl.Texture,
 	width, height: i32,
+	src: sdl.Rect,
+	page: i32,
+	cacheEntry: ^ImageCacheEntry,
+	job: ^ImageJob,
+}
+
+ImageCacheEntry :: struct {
+	path: cstring,
+	hash: u32,
+
+	texture: ^sdl.Texture,
+	src: sdl.Rect,
+	page: i32,
+	refCount: i32,
+
+	hashNext: ^ImageCacheEntry,
+}
+
+ImageCache :: struct {
+	buckets: ^^ImageCacheEntry,
+	numBuckets, numEntries: i32,
+	hits, misses: i32,
+}
+
+CommandType :: enum i32 {
+	COMMAND_SLIDER_VALUE,
+	COMMAND_TEXT,
+	COMMAND_HIDDEN,
+}
+
+Command :: struct {
+	next: ^Command,
+	type: CommandType,
+	component: rawptr,
+	value: f32,
+	str: cstring,
+	hidden: bool,
+}
+
+FrameStats :: struct {
+	renderCalls, textureBinds: i32,
+	componentsVisited, hitTests: i32,
+	callbacks: i32,
+	callbackTicks: u64,
+	texturesCreated, texturesDestroyed: i32,
+	layoutVisits: i32,
+}
+
+CommandQueue :: struct {
+	head, tail: ^Command,
+	stub: Command,
+	wake: sdl.atomic_t,
+	eventType: u32,
+	drainCount: u32,
+
+	drained: [^]^Command,
+	numDrained, drainedCapacity: i32,
+}
+
+PACK_VERSION :: 1
+
+Pack :: struct {
+	path: cstring,
+	data: [^]u8,
+	size: uint,
+	count: u32,
+	file, mapping: rawptr,
+}
+
+LOADER_MAX_THREADS :: 4
+
+ImageJob :: struct {
+	path: cstring,
+	xScale, yScale: f32,
+	image: rawptr,
+	surface: ^sdl.Surface,
+	next: ^ImageJob,
+}
+
+ImageLoader :: struct {
+	threads: [LOADER_MAX_THREADS]^sdl.Thread,
+	numThreads: i32,
+	lock: ^sdl.mutex,
+	wake: ^sdl.cond,
+	pending, pendingTail, done: ^ImageJob,
+	eventType: u32,
+	quit: bool,
 }
 
 Button :: struct {
@@ -76,7 +331,7 @@ Button :: struct {
 	imageContent: ^Image,
 	x, y, width, height, borderWidth: i32,
 	fillColor, borderColor: sdl.Color,
-	inside, pressed, onScreen: bool,
+	inside, pressed: bool,
 }
 
 Slider :: struct {
@@ -85,7 +340,72 @@ Slider :: struct {
 	vertical: bool,
 	sliderColor, handleColor: sdl.Color,
 	value, buttonValueMod: f32,
-	holding, onScreen: bool,
+	holding: bool,
+	param: ^SliderParam,
+	target: ^ComponentNode,
+}
+
+SliderParam :: struct {
+	value: sdl.atomic_t,
+	current, target, step: f32,
+	rampSamples, remaining: i32,
+}
+
+LayoutType :: enum i32 {
+	LAYOUT_HSTACK,
+	LAYOUT_VSTACK,
+	LAYOUT_GRID,
+	LAYOUT_ANCHOR,
+}
+
+Anchor :: enum i32 {
+	ANCHOR_TOP_LEFT,
+	ANCHOR_TOP,
+	ANCHOR_TOP_RIGHT,
+	ANCHOR_LEFT,
+	ANCHOR_CENTER,
+	ANCHOR_RIGHT,
+	ANCHOR_BOTTOM_LEFT,
+	ANCHOR_BOTTOM,
+	ANCHOR_BOTTOM_RIGHT,
+}
+
+LayoutChild :: struct {
+	node: ^ComponentNode,
+	anchor: Anchor,
+	offsetX, offsetY: i32,
+}
+
+Container :: struct {
+	layout: LayoutType,
+	width, height: i32,
+	padding, spacing, columns: i32,
+	children: [^]LayoutChild,
+	numChildren, childrenCapacity: i32,
+
+	measuredWidth, measuredHeight, cellWidth, cellHeight: i32,
+	rect: sdl.Rect,
+	measureValid, arrangeValid: bool,
+
+	clip: bool,
+	scrollX, scrollY, contentWidth, contentHeight: i32,
+	hSlider, vSlider: ^Slider,
+}
+
+ListView :: struct {
+	source: ListViewSource,
+	data: rawptr,
+	numRows, rowHeight: i32,
+	x, y, width, height: i32,
+	font: FontID,
+	fg, fillColor, selectedColor: sdl.Color,
+	slider: ^Slider,
+	scroll, selected: i32,
+
+	rows: [^]^Text,
+	rowIndices: [^]i32,
+	numPooled: i32,
+	inside: bool,
 }
 
 @(link_prefix = "GUI_", default_calling_convention = "c")
@@ -93,18 +413,46 @@ foreign sdlgui {
 	Init :: proc(win: ^sdl.Window, render: ^sdl.Renderer) -> ^Context ---
 	Quit :: proc(gui: ^Context) ---
 
-	SerializeComponent :: proc(ctx: ^Context, component: rawptr) ---
+	GetFrameStats :: proc(ctx: ^Context, stats: ^FrameStats) ---
+
+	SetBatching :: proc(ctx: ^Context, batching: bool) ---
+	Flush :: proc(ctx: ^Context) ---
+
+	Place :: proc(ctx: ^Context, component: rawptr, x, y: i32) ---
+	Unplace :: proc(ctx: ^Context, component: rawptr) ---
+	MarkDirty :: proc(ctx: ^Context, component: rawptr) ---
+	NeedsRedraw :: proc(ctx: ^Context) -> bool ---
+	Render :: proc(ctx: ^Context) ---
+
+	SerializeComponent :: proc(ctx: ^Context, component: rawptr, componentType: ComponentType) -> bool ---
 	FreeComponent :: proc(ctx: ^Context, component: rawptr) ---
+	FindComponent :: proc(ctx: ^Context, component: rawptr) -> ^ComponentNode ---
+	SetHidden :: proc(ctx: ^Context, component: rawptr, hidden: bool) ---
+	PostSliderValue :: proc(ctx: ^Context, slider: ^Slider, value: f32) -> bool ---
+	PostText :: proc(ctx: ^Context, text: ^Text, str: cstring) -> bool ---
+	PostHidden :: proc(ctx: ^Context, component: rawptr, hidden: bool) -> bool ---
 	NewFont :: proc(ctx: ^Context, path: cstring, ptsize: i32) -> FontID ---
+	NewFontFromPack :: proc(ctx: ^Context, pack: PackID, name: cstring, ptsize: i32) -> FontID ---
+	OpenPack :: proc(ctx: ^Context, path: cstring) -> PackID ---
+	BakeFont :: proc(ctx: ^Context, font: FontID, path: cstring) -> bool ---
+	NewBakedFont :: proc(ctx: ^Context, bakedPath, fontPath: cstring, ptsize: i32) -> FontID ---
 
 	NewTextBg :: proc(ctx: ^Context, font: FontID, str: cstring, fg, bg: sdl.Color) -> ^Text ---
 	NewText :: proc(ctx: ^Context, font: FontID, str: cstring, fg: sdl.Color) -> ^Text ---
 	FreeText :: proc(ctx: ^Context, text: ^Text) ---
+	SetText :: proc(ctx: ^Context, text: ^Text, str: cstring) -> bool ---
+	SetTextCacheBudget :: proc(ctx: ^Context, bytes: uint) ---
 	DrawText :: proc(ctx: ^Context, text: ^Text, x, y: i32) ---
 
+	DrawString :: proc(ctx: ^Context, font: FontID, str: cstring, color: sdl.Color, x, y: i32) ---
+	SizeString :: proc(ctx: ^Context, font: FontID, str: cstring, width, height: ^i32) ---
+
 	NewImage :: proc(ctx: ^Context, path: cstring, xScale, yScale: f32) -> ^Image ---
+	NewImageAsync :: proc(ctx: ^Context, path: cstring, xScale, yScale: f32) -> ^Image ---
+	NewImageFromPack :: proc(ctx: ^Context, pack: PackID, name: cstring, xScale, yScale: f32) -> ^Image ---
 	FreeImage :: proc(ctx: ^Context, image: ^Image) ---
 	DrawImage :: proc(ctx: ^Context, image: ^Image, x, y: i32) ---
+	SetImageAtlas :: proc(ctx: ^Context, enabled: bool) ---
 
 	NewButton :: proc(ctx: ^Context, width, height, borderWidth: i32, fillColor, borderColor: sdl.Color, textContext: ^Text, imageContext: ^Image) -> ^Button ---
 	FreeButton :: proc(ctx: ^Context, button: ^Button) ---
@@ -113,11 +461,43 @@ foreign sdlgui {
 	NewSlider :: proc(ctx: ^Context, incrementButton, decrementButton: ^Button, buttonValueMod: f32, width, length: i32, vertical: bool, sliderColor, handleColor: sdl.Color) -> ^Slider ---
 	FreeSlider :: proc(ctx: ^Context, slider: ^Slider) ---
 	DrawSlider :: proc(ctx: ^Context, slider: ^Slider, x, y: i32) ---
+	SetSliderValue :: proc(ctx: ^Context, slider: ^Slider, value: f32) ---
+	SetSliderParam :: proc(slider: ^Slider, param: ^SliderParam) ---
+	InitSliderParam :: proc(param: ^SliderParam, value: f32, rampSamples: i32) ---
+	ReadSliderParam :: proc(param: ^SliderParam) -> f32 ---
+	NextSliderSample :: proc(param: ^SliderParam) -> f32 ---
+
+	NewContainer :: proc(ctx: ^Context, layout: LayoutType, width, height, padding, spacing, columns: i32) -> ^Container ---
+	FreeContainer :: proc(ctx: ^Context, container: ^Container) ---
+	AddChild :: proc(ctx: ^Context, container: ^Container, component: rawptr) -> bool ---
+	AddAnchoredChild :: proc(ctx: ^Context, container: ^Container, component: rawptr, anchor: Anchor, offsetX, offsetY: i32) -> bool ---
+	RemoveChild :: proc(ctx: ^Context, container: ^Container, component: rawptr) -> bool ---
+	SetContainerSize :: proc(ctx: ^Context, container: ^Container, width, height: i32) ---
+	SetRootContainer :: proc(ctx: ^Context, container: ^Container) ---
+	InvalidateLayout :: proc(ctx: ^Context, component: rawptr) ---
+	DrawContainer :: proc(ctx: ^Context, container: ^Container, x, y: i32) ---
+	NewScrollPanel :: proc(ctx: ^Context, layout: LayoutType, width, height, padding, spacing, columns: i32) -> ^Container ---
+	ScrollContainer :: proc(ctx: ^Context, container: ^Container, scrollX, scrollY: i32) ---
+	SetScrollSlider :: proc(ctx: ^Context, container: ^Container, slider: ^Slider) ---
+
+	NewListView :: proc(ctx: ^Context, source: ListViewSource, data: rawptr, numRows, rowHeight, width, height: i32, font: FontID, fg, fillColor, selectedColor: sdl.Color, slider: ^Slider) -> ^ListView ---
+	FreeListView :: proc(ctx: ^Context, list: ^ListView) ---
+	SetListViewRows :: proc(ctx: ^Context, list: ^ListView, numRows: i32) ---
+	ScrollListView :: proc(ctx: ^Context, list: ^ListView, scroll: i32) ---
+	DrawListView :: proc(ctx: ^Context, list: ^ListView, x, y: i32) ---
 
 	IsPointInsideRect :: proc(mx, my, x, y, w, h: i32) -> bool ---
+	HitTestRects :: proc(mx, my: i32, x0, y0, x1, y1: [^]i32, count: i32, mask: [^]u32) ---
 	AddEvent :: proc(ctx: ^Context, component: rawptr, event: Event, type: EventType) -> bool ---
 	ClearEvents :: proc(ctx: ^Context, component: rawptr) -> bool ---
 	RemoveEvent :: proc(ctx: ^Context, component: rawptr, event: Event, type: EventType) -> bool ---
 	TriggerEvents :: proc(ctx: ^Context, component: rawptr, type: EventType) -> bool ---
 	Update :: proc(ctx: ^Context, event: sdl.Event) -> bool ---
+	UpdateBatch :: proc(ctx: ^Context, events: [^]sdl.Event, count: i32, results: [^]bool) -> bool ---
+	WaitAndUpdate :: proc(ctx: ^Context, event: ^sdl.Event, timeout: i32) -> bool ---
+	NeedsFrame :: proc(ctx: ^Context) -> bool ---
+	RequestRedraw :: proc(ctx: ^Context) ---
+	FrameDone :: proc(ctx: ^Context) ---
+	SetAnimating :: proc(ctx: ^Context, animating: bool) ---
+	Run :: proc(ctx: ^Context, onEvent: EventHandler, onDraw: DrawHandler, data: rawptr) -> bool ---
 }
@@ -0,0 +1,773 @@
+// Headless benchmarks for the library, built and run with `make bench`.
+//
+// Runs on SDL's dummy video driver with the software renderer, so it needs neither a GPU nor a display.
+// Each benchmark is run at every scale from 10 to 100000 components and repeated until it has run for
+// at least MIN_SECONDS. Results are printed as JSON, or as CSV when given --csv:
+//   benchmark, components, iterations, ns per iteration, ns per component, frames, cpu percent, render calls
+// The layout benchmarks time GUI_Render on a column of rows of buttons, once after invalidating every
+// container and once after resizing a single button. list_view_scroll scrolls a list view of that many
+// rows down by a row each frame, and scroll_panel scrolls a panel holding that many buttons, of which
+// only half a window's worth is visible.
+// hit_test_scalar and hit_test_kernel test a frame of pointer positions against that many rects, one
+// GUI_IsPointInsideRect call at a time and with GUI_HitTestRects.
+// slider_param_write moves a slider through 2^20 values on the GUI thread while another thread checks every
+// value it reads from the slider's GUI_SliderParam, and times each write; a torn or out of order read fails
+// the run with a non-zero exit.
+// draw_unbatched and draw_batched draw the same BATCHING_COMPONENTS bordered buttons with batching off and
+// on; built with `make bench-stats` they also report the renderer calls one frame makes each way.
+// update_frame and update_batch are also run at DENSE_COMPONENTS, where every grid cell lists hundreds of
+// overlapping components and hit-testing is bound by how much memory each candidate costs to look at.
+// The idle benchmarks leave a window of components untouched for IDLE_SECONDS, once with a loop that
+// polls and redraws every frame and once with GUI_Run, and report the frames drawn and the CPU time used.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sdl2_gui.h"
+
+#define WIN_WIDTH 800
+#define WIN_HEIGHT 600
+#define CELL_SIZE 20
+#define COMPONENT_SIZE 16
+
+#define MIN_SECONDS 0.05
+#define MAX_ITERATIONS 1000
+#define MAX_RESULTS 128
+#define FRAME_EVENTS 18
+#define DISTINCT_STRINGS 64
+#define IDLE_SECONDS 1
+#define IDLE_COMPONENTS 1000
+#define ROW_COMPONENTS 10
+#define LIST_ROW_HEIGHT 20
+#define DENSE_COMPONENTS 50000
+#define BATCHING_COMPONENTS 500
+#define PARAM_WRITES (1 << 20)
+
+typedef struct {
+	const char *name;
+	int count, iterations;
+	double nsPerIteration, nsPerComponent;
+	int frames;
+	double cpuPercent;
+	int renderCalls;
+} Result;
+
+SDL_Window *win;
+SDL_Renderer *render;
+GUI_Context *gui;
+GUI_FontID font = -1;
+
+Result results[MAX_RESULTS];
+int numResults;
+
+Uint64 frequency;
+int hitCount;
+
+void onEvent(void *component) {
+}
+
+static void record(const char *name, int count, int iterations, Uint64 ticks) {
+	if(numResults >= MAX_RESULTS)
+		return;
+
+	double ns = (double) ticks * 1e9 / frequency / iterations;
+	results[numResults++] = (Result) {name, count, iterations, ns, ns / count, -1, -1, -1};
+}
+static void recordRenderCalls(const char *name, int count, int iterations, Uint64 ticks, int renderCalls) {
+	if(numResults >= MAX_RESULTS)
+		return;
+
+	record(name, count, iterations, ticks);
+	results[numResults - 1].renderCalls = renderCalls;
+}
+static void recordIdle(const char *name, int count, int frames, double seconds, clock_t cpu) {
+	if(numResults >= MAX_RESULTS)
+		return;
+
+	double cpuSeconds = (double) cpu / CLOCKS_PER_SEC;
+	results[numResults++] = (Result) {name, count, 1, seconds * 1e9, seconds * 1e9 / count, frames, cpuSeconds / seconds * 100, -1};
+}
+
+static bool keepGoing(int iterations, Uint64 ticks) {
+	return iterations == 0 || (ticks < MIN_SECONDS * frequency && iterations < MAX_ITERATIONS);
+}
+
+// components are laid out on a grid that wraps around the window, so large counts overlap the way a
+// dense UI would and every component stays hit-testable
+static void position(int i, int *x, int *y) {
+	int columns = WIN_WIDTH / CELL_SIZE, rows = WIN_HEIGHT / CELL_SIZE;
+
+	*x = (i % columns) * CELL_SIZE;
+	*y = (i / columns % rows) * CELL_SIZE;
+}
+
+static GUI_Button** newButtons(int count) {
+	GUI_Button **buttons = (GUI_Button**) malloc(count * sizeof(GUI_Button*));
+
+	for(int i = 0; i < count; i++) {
+		buttons[i] = GUI_NewButton(gui, COMPONENT_SIZE, COMPONENT_SIZE, 1, COLOR_RED, COLOR_BLACK, NULL, NULL);
+	}
+
+	return buttons;
+}
+static void freeButtons(GUI_Button **buttons, int count) {
+	for(int i = 0; i < count; i++) {
+		GUI_FreeComponent(gui, buttons[i]);
+	}
+
+	free(buttons);
+}
+static void drawButtons(GUI_Button **buttons, int count) {
+	int x, y;
+
+	for(int i = 0; i < count; i++) {
+		position(i, &x, &y);
+		GUI_DrawButton(gui, buttons[i], x, y);
+	}
+
+	GUI_Flush(gui);
+}
+
+static void benchCreateFree(int count) {
+	GUI_Button **buttons = (GUI_Button**) malloc(count * sizeof(GUI_Button*));
+	Uint64 createTicks = 0, freeTicks = 0;
+	int iterations = 0;
+
+	while(keepGoing(iterations, createTicks + freeTicks)) {
+		Uint64 start = SDL_GetPerformanceCounter();
+		for(int i = 0; i < count; i++) {
+			buttons[i] = GUI_NewButton(gui, COMPONENT_SIZE, COMPONENT_SIZE, 1, COLOR_RED, COLOR_BLACK, NULL, NULL);
+		}
+
+		Uint64 middle = SDL_GetPerformanceCounter();
+		for(int i = 0; i < count; i++) {
+			GUI_FreeComponent(gui, buttons[i]);
+		}
+
+		Uint64 end = SDL_GetPerformanceCounter();
+		createTicks += middle - start;
+		freeTicks += end - middle;
+		iterations++;
+	}
+
+	record("create_button", count, iterations, createTicks);
+	record("free_button", count, iterations, freeTicks);
+	free(buttons);
+
+	GUI_Slider **sliders = (GUI_Slider**) malloc(count * sizeof(GUI_Slider*));
+	createTicks = freeTicks = 0;
+	iterations = 0;
+
+	while(keepGoing(iterations, createTicks + freeTicks)) {
+		Uint64 start = SDL_GetPerformanceCounter();
+		for(int i = 0; i < count; i++) {
+			sliders[i] = GUI_NewSlider(gui, NULL, NULL, 0, 4, COMPONENT_SIZE, false, COLOR_LIGHT_GREY, COLOR_MAGENTA);
+		}
+
+		Uint64 middle = SDL_GetPerformanceCounter();
+		for(int i = 0; i < count; i++) {
+			GUI_FreeComponent(gui, sliders[i]);
+		}
+
+		Uint64 end = SDL_GetPerformanceCounter();
+		createTicks += middle - start;
+		freeTicks += end - middle;
+		iterations++;
+	}
+
+	record("create_slider", count, iterations, createTicks);
+	record("free_slider", count, iterations, freeTicks);
+	free(sliders);
+}
+
+static void benchEvents(int count) {
+	GUI_Button **buttons = newButtons(count);
+	Uint64 addTicks = 0, removeTicks = 0;
+	int iterations = 0;
+
+	while(keepGoing(iterations, addTicks + removeTicks)) {
+		Uint64 start = SDL_GetPerformanceCounter();
+		for(int i = 0; i < count; i++) {
+			GUI_AddEvent(gui, buttons[i], &onEvent, GUI_BUTTON_ON_PRESS);
+		}
+
+		Uint64 middle = SDL_GetPerformanceCounter();
+		for(int i = 0; i < count; i++) {
+			GUI_RemoveEvent(gui, buttons[i], &onEvent, GUI_BUTTON_ON_PRESS);
+		}
+
+		Uint64 end = SDL_GetPerformanceCounter();
+		addTicks += middle - start;
+		removeTicks += end - middle;
+		iterations++;
+	}
+
+	record("add_event", count, iterations, addTicks);
+	record("remove_event", count, iterations, removeTicks);
+	freeButtons(buttons, count);
+}
+
+static void benchDraw(int count) {
+	GUI_Button **buttons = newButtons(count);
+	Uint64 ticks = 0;
+	int iterations = 0;
+
+	while(keepGoing(iterations, ticks)) {
+		SDL_RenderClear(render);
+
+		Uint64 start = SDL_GetPerformanceCounter();
+		drawButtons(buttons, count);
+		ticks += SDL_GetPerformanceCounter() - start;
+		iterations++;
+
+		SDL_RenderPresent(render);
+	}
+
+	record("draw_button", count, iterations, ticks);
+	freeButtons(buttons, count);
+
+	GUI_Slider **sliders = (GUI_Slider**) malloc(count * sizeof(GUI_Slider*));
+	for(int i = 0; i < count; i++) {
+		sliders[i] = GUI_NewSlider(gui, NULL, NULL, 0, 4, COMPONENT_SIZE, false, COLOR_LIGHT_GREY, COLOR_MAGENTA);
+	}
+
+	ticks = 0;
+	iterations = 0;
+	while(keepGoing(iterations, ticks)) {
+		SDL_RenderClear(render);
+
+		Uint64 start = SDL_GetPerformanceCounter();
+		for(int i = 0; i < count; i++) {
+			int x, y;
+			position(i, &x, &y);
+			GUI_DrawSlider(gui, sliders[i], x, y);
+		}
+		GUI_Flush(gui);
+
+		ticks += SDL_GetPerformanceCounter() - start;
+		iterations++;
+
+		SDL_RenderPresent(render);
+	}
+
+	record("draw_slider", count, iterations, ticks);
+	for(int i = 0; i < count; i++) {
+		GUI_FreeComponent(gui, sliders[i]);
+	}
+	free(sliders);
+
+	if(font < 0)
+		return;
+
+	// a handful of distinct strings, the way labels repeat in a real UI
+	GUI_Text **texts = (GUI_Text**) malloc(count * sizeof(GUI_Text*));
+	char str[32];
+	for(int i = 0; i < count; i++) {
+		snprintf(str, sizeof(str), "label %d", i % DISTINCT_STRINGS);
+		texts[i] = GUI_NewText(gui, font, str, COLOR_WHITE);
+	}
+
+	ticks = 0;
+	iterations = 0;
+	while(keepGoing(iterations, ticks)) {
+		SDL_RenderClear(render);
+
+		Uint64 start = SDL_GetPerformanceCounter();
+		for(int i = 0; i < count; i++) {
+			int x, y;
+			position(i, &x, &y);
+			GUI_DrawText(gui, texts[i], x, y);
+		}
+		GUI_Flush(gui);
+
+		ticks += SDL_GetPerformanceCounter() - start;
+		iterations++;
+
+		SDL_RenderPresent(render);
+	}
+
+	record("draw_text", count, iterations, ticks);
+	for(int i = 0; i < count; i++) {
+		GUI_FreeComponent(gui, texts[i]);
+	}
+	free(texts);
+}
+
+// GUI_HitTestRects has to agree with GUI_IsPointInsideRect on every rect, for points on and just past
+// the edges of rects spread across the set, before it's worth timing
+static bool checkHitTest(const int *x0, const int *y0, const int *x1, const int *y1, int count, Uint32 *mask) {
+	int samples = SDL_min(count, 64);
+
+	for(int k = 0; k < samples; k++) {
+		int r = k * count / samples;
+		int xs[] = {x0[r] - 1, x0[r], x1[r], x1[r] + 1}, ys[] = {y0[r] - 1, y0[r], y1[r], y1[r] + 1};
+
+		for(int p = 0; p < 16; p++) {
+			GUI_HitTestRects(xs[p % 4], ys[p / 4], x0, y0, x1, y1, count, mask);
+
+			for(int i = 0; i < count; i++) {
+				bool hit = (mask[i / 32] >> (i % 32)) & 1;
+				if(hit != GUI_IsPointInsideRect(xs[p % 4], ys[p / 4], x0[i], y0[i], x1[i] - x0[i], y1[i] - y0[i])) {
+					fprintf(stderr, "GUI_HitTestRects disagrees with GUI_IsPointInsideRect at (%d, %d) for rect %d\n", xs[p % 4], ys[p / 4], i);
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+static void benchHitTest(int count) {
+	int *rects = (int*) malloc(count * 4 * sizeof(int));
+	int *x0 = rects, *y0 = rects + count, *x1 = rects + count * 2, *y1 = rects + count * 3;
+	Uint32 *mask = (Uint32*) malloc((count + 31) / 32 * sizeof(Uint32));
+	Uint64 scalarTicks = 0, kernelTicks = 0;
+	int iterations = 0, hits = 0;
+
+	for(int i = 0; i < count; i++) {
+		position(i, &x0[i], &y0[i]);
+		x1[i] = x0[i] + COMPONENT_SIZE;
+		y1[i] = y0[i] + COMPONENT_SIZE;
+	}
+
+	if(!checkHitTest(x0, y0, x1, y1, count, mask))
+		exit(1);
+
+	while(keepGoing(iterations, scalarTicks + kernelTicks)) {
+		Uint64 start = SDL_GetPerformanceCounter();
+		for(int e = 0; e < FRAME_EVENTS; e++) {
+			for(int i = 0; i < count; i++) {
+				hits += GUI_IsPointInsideRect(e * WIN_WIDTH / FRAME_EVENTS, e * WIN_HEIGHT / FRAME_EVENTS, x0[i], y0[i], x1[i] - x0[i], y1[i] - y0[i]);
+			}
+		}
+		scalarTicks += SDL_GetPerformanceCounter() - start;
+
+		start = SDL_GetPerformanceCounter();
+		for(int e = 0; e < FRAME_EVENTS; e++) {
+			GUI_HitTestRects(e * WIN_WIDTH / FRAME_EVENTS, e * WIN_HEIGHT / FRAME_EVENTS, x0, y0, x1, y1, count, mask);
+			hits += mask[0] & 1;
+		}
+		kernelTicks += SDL_GetPerformanceCounter() - start;
+
+		iterations++;
+	}
+
+	hitCount = hits;
+	record("hit_test_scalar", count, iterations, scalarTicks);
+	record("hit_test_kernel", count, iterations, kernelTicks);
+	free(rects);
+	free(mask);
+}
+
+// The GUI thread moves a slider through PARAM_WRITES increasing values while another thread reads its
+// parameter the way an audio callback would. Every value written is a multiple of 1 / PARAM_WRITES, so a
+// torn read shows up as a value that isn't one, and the reader must never see the value go down.
+typedef struct {
+	GUI_Slider *slider;
+	GUI_SliderParam param;
+	SDL_atomic_t done;
+} ParamStress;
+
+static int paramReader(void *data) {
+	ParamStress *stress = (ParamStress*) data;
+	float last = 0;
+	bool done = false;
+
+	while(!done) {
+		done = SDL_AtomicGet(&stress->done) != 0;
+		float value = GUI_ReadSliderParam(&stress->param);
+		double scaled = (double) value * PARAM_WRITES;
+
+		if(value < 0 || value > 1 || scaled != (double) (int) scaled) {
+			fprintf(stderr, "slider param: torn read %.9g\n", value);
+			return 1;
+		}
+		if(value < last) {
+			fprintf(stderr, "slider param: read %.9g after %.9g\n", value, last);
+			return 1;
+		}
+		if(done && value != 1) {
+			fprintf(stderr, "slider param: read %.9g after the last write\n", value);
+			return 1;
+		}
+
+		last = value;
+	}
+
+	return 0;
+}
+static bool benchSliderParam(void) {
+	ParamStress stress;
+	int readerStatus = 1;
+
+	stress.slider = GUI_NewSlider(gui, NULL, NULL, 0, 4, COMPONENT_SIZE, false, COLOR_LIGHT_GREY, COLOR_MAGENTA);
+	GUI_SetSliderValue(gui, stress.slider, 0);
+	GUI_InitSliderParam(&stress.param, 0, 0);
+	GUI_SetSliderParam(stress.slider, &stress.param);
+	SDL_AtomicSet(&stress.done, 0);
+
+	SDL_Thread *reader = SDL_CreateThread(&paramReader, "param reader", &stress);
+	if(reader == NULL) {
+		fprintf(stderr, "could not start the slider param reader: %s\n", SDL_GetError());
+		GUI_FreeComponent(gui, stress.slider);
+		return false;
+	}
+
+	// written from this thread, the GUI thread, like a drag would, while the reader keeps hitting the same line
+	Uint64 start = SDL_GetPerformanceCounter();
+	for(int i = 1; i <= PARAM_WRITES; i++) {
+		GUI_SetSliderValue(gui, stress.slider, (float) i / PARAM_WRITES);
+	}
+	Uint64 ticks = SDL_GetPerformanceCounter() - start;
+
+	SDL_AtomicSet(&stress.done, 1);
+	SDL_WaitThread(reader, &readerStatus);
+
+	record("slider_param_write", 1, PARAM_WRITES, ticks);
+	GUI_SetSliderParam(stress.slider, NULL);
+	GUI_FreeComponent(gui, stress.slider);
+
+	return readerStatus == 0;
+}
+
+// draws the same bordered buttons with batching off and then on; renderer calls are only counted when the
+// bench and the library are built with GUI_ENABLE_STATS, and are reported as -1 otherwise
+static void benchBatching(int count) {
+	GUI_Button **buttons = newButtons(count);
+	GUI_FrameStats stats;
+
+	for(int batching = 0; batching <= 1; batching++) {
+		Uint64 ticks = 0;
+		int iterations = 0, renderCalls = -1;
+
+		GUI_SetBatching(gui, batching);
+		while(keepGoing(iterations, ticks)) {
+			SDL_RenderClear(render);
+			GUI_GetFrameStats(gui, &stats);
+
+			Uint64 start = SDL_GetPerformanceCounter();
+			drawButtons(buttons, count);
+			ticks += SDL_GetPerformanceCounter() - start;
+			iterations++;
+
+			GUI_GetFrameStats(gui, &stats);
+#ifdef GUI_ENABLE_STATS
+			renderCalls = stats.renderCalls;
+#endif
+			SDL_RenderPresent(render);
+		}
+
+		recordRenderCalls(batching ? "draw_batched" : "draw_unbatched", count, iterations, ticks, renderCalls);
+	}
+
+	GUI_SetBatching(gui, true);
+	freeButtons(buttons, count);
+}
+
+static void benchUpdate(int count) {
+	GUI_Button **buttons = newButtons(count);
+	SDL_Event events[FRAME_EVENTS];
+	Uint64 updateTicks = 0, batchTicks = 0;
+	int iterations = 0;
+
+	for(int i = 0; i < count; i++) {
+		GUI_AddEvent(gui, buttons[i], &onEvent, GUI_BUTTON_ON_ENTER);
+		GUI_AddEvent(gui, buttons[i], &onEvent, GUI_BUTTON_ON_PRESS);
+	}
+
+	// a frame's worth of input: the pointer sweeps across the window, then clicks
+	memset(events, 0, sizeof(events));
+	for(int i = 0; i < FRAME_EVENTS - 2; i++) {
+		events[i].type = SDL_MOUSEMOTION;
+		events[i].motion.x = i * WIN_WIDTH / (FRAME_EVENTS - 2);
+		events[i].motion.y = i * WIN_HEIGHT / (FRAME_EVENTS - 2);
+	}
+	events[FRAME_EVENTS - 2].type = SDL_MOUSEBUTTONDOWN;
+	events[FRAME_EVENTS - 1].type = SDL_MOUSEBUTTONUP;
+	for(int i = FRAME_EVENTS - 2; i < FRAME_EVENTS; i++) {
+		events[i].button.button = SDL_BUTTON_LEFT;
+		events[i].button.x = COMPONENT_SIZE / 2;
+		events[i].button.y = COMPONENT_SIZE / 2;
+	}
+
+	while(keepGoing(iterations, updateTicks + batchTicks)) {
+		// components are only hit-tested while they're on screen, so each frame draws them first
+		drawButtons(buttons, count);
+
+		Uint64 start = SDL_GetPerformanceCounter();
+		for(int i = 0; i < FRAME_EVENTS; i++) {
+			GUI_Update(gui, events[i]);
+		}
+		updateTicks += SDL_GetPerformanceCounter() - start;
+
+		drawButtons(buttons, count);
+
+		start = SDL_GetPerformanceCounter();
+		GUI_UpdateBatch(gui, events, FRAME_EVENTS, NULL);
+		batchTicks += SDL_GetPerformanceCounter() - start;
+
+		iterations++;
+	}
+
+	record("update_frame", count, iterations, updateTicks);
+	record("update_batch_frame", count, iterations, batchTicks);
+	freeButtons(buttons, count);
+}
+
+static const char* listRow(int row, void *data) {
+	static char str[32];
+	snprintf(str, sizeof(str), "row %d", row);
+	return str;
+}
+static void benchListView(int count) {
+	if(font < 0)
+		return;
+
+	GUI_ListView *list = GUI_NewListView(gui, &listRow, NULL, count, LIST_ROW_HEIGHT, WIN_WIDTH / 2, WIN_HEIGHT, font, COLOR_WHITE, COLOR_BLACK, COLOR_DARK_GREY, NULL);
+	int visibleRows = WIN_HEIGHT / LIST_ROW_HEIGHT;
+	Uint64 ticks = 0;
+	int iterations = 0;
+
+	GUI_DrawListView(gui, list, 0, 0);
+	GUI_Flush(gui);
+
+	while(keepGoing(iterations, ticks)) {
+		int scroll = iterations % SDL_max(1, count - visibleRows) * LIST_ROW_HEIGHT;
+
+		Uint64 start = SDL_GetPerformanceCounter();
+		GUI_ScrollListView(gui, list, scroll);
+		GUI_DrawListView(gui, list, 0, 0);
+		GUI_Flush(gui);
+		ticks += SDL_GetPerformanceCounter() - start;
+
+		iterations++;
+	}
+
+	record("list_view_scroll", count, iterations, ticks);
+	GUI_FreeComponent(gui, list);
+}
+
+static void benchScrollPanel(int count) {
+	GUI_Container *panel = GUI_NewScrollPanel(gui, GUI_LAYOUT_GRID, WIN_WIDTH, WIN_HEIGHT / 2, 0, CELL_SIZE - COMPONENT_SIZE, WIN_WIDTH / CELL_SIZE);
+	GUI_Button **buttons = newButtons(count);
+	Uint64 ticks = 0;
+	int iterations = 0;
+
+	for(int i = 0; i < count; i++) {
+		GUI_AddChild(gui, panel, buttons[i]);
+	}
+
+	GUI_Place(gui, panel, 0, 0);
+	GUI_Render(gui);
+
+	while(keepGoing(iterations, ticks)) {
+		Uint64 start = SDL_GetPerformanceCounter();
+		GUI_ScrollContainer(gui, panel, 0, iterations % 2 * CELL_SIZE);
+		GUI_Render(gui);
+		ticks += SDL_GetPerformanceCounter() - start;
+
+		iterations++;
+	}
+
+	record("scroll_panel", count, iterations, ticks);
+	GUI_FreeComponent(gui, panel);
+	freeButtons(buttons, count);
+}
+
+static void benchLayout(int count) {
+	int numRows = (count + ROW_COMPONENTS - 1) / ROW_COMPONENTS;
+	GUI_Container **rows = (GUI_Container**) malloc(numRows * sizeof(GUI_Container*));
+	GUI_Container *column = GUI_NewContainer(gui, GUI_LAYOUT_VSTACK, 0, 0, 4, 2, 0);
+	GUI_Button **buttons = newButtons(count);
+	Uint64 fullTicks = 0, oneTicks = 0;
+	int iterations = 0;
+
+	for(int i = 0; i < numRows; i++) {
+		rows[i] = GUI_NewContainer(gui, GUI_LAYOUT_HSTACK, 0, 0, 0, 2, 0);
+		GUI_AddChild(gui, column, rows[i]);
+	}
+	for(int i = 0; i < count; i++) {
+		GUI_AddChild(gui, rows[i / ROW_COMPONENTS], buttons[i]);
+	}
+
+	GUI_Place(gui, column, 0, 0);
+	GUI_Render(gui);
+
+	// only the middle row is arranged again, the other rows keep their cached layout
+	GUI_Button *resized = buttons[numRows / 2 * ROW_COMPONENTS];
+
+	while(keepGoing(iterations, fullTicks + oneTicks)) {
+		Uint64 start = SDL_GetPerformanceCounter();
+		for(int i = 0; i < numRows; i++) {
+			GUI_InvalidateLayout(gui, rows[i]);
+		}
+		GUI_Render(gui);
+		fullTicks += SDL_GetPerformanceCounter() - start;
+
+		start = SDL_GetPerformanceCounter();
+		resized->width = resized->width == COMPONENT_SIZE ? COMPONENT_SIZE * 2 : COMPONENT_SIZE;
+		GUI_InvalidateLayout(gui, resized);
+		GUI_Render(gui);
+		oneTicks += SDL_GetPerformanceCounter() - start;
+
+		iterations++;
+	}
+
+	record("layout_full", count, iterations, fullTicks);
+	record("relayout_one", count, iterations, oneTicks);
+
+	GUI_FreeComponent(gui, column);
+	for(int i = 0; i < numRows; i++) {
+		GUI_FreeComponent(gui, rows[i]);
+	}
+	free(rows);
+	freeButtons(buttons, count);
+}
+
+static GUI_Button **idleButtons;
+static int idleCount, idleFrames;
+
+static bool idleEvent(SDL_Event *event, void *data) {
+	return event->type == SDL_QUIT;
+}
+static void idleDraw(void *data) {
+	SDL_RenderClear(render);
+	drawButtons(idleButtons, idleCount);
+	idleFrames++;
+}
+static Uint32 idleTimeout(Uint32 interval, void *data) {
+	SDL_Event event;
+	memset(&event, 0, sizeof(SDL_Event));
+	event.type = SDL_QUIT;
+	SDL_PushEvent(&event);
+	return 0;
+}
+
+static void benchIdle(int count) {
+	idleButtons = newButtons(count);
+	idleCount = count;
+
+	// the loop from src/example.c before GUI_Run, which redraws as fast as it can
+	SDL_Event event;
+	Uint64 end = SDL_GetPerformanceCounter() + IDLE_SECONDS * frequency;
+	clock_t cpu = clock();
+	idleFrames = 0;
+
+	while(SDL_GetPerformanceCounter() < end) {
+		while(SDL_PollEvent(&event)) {
+			GUI_Update(gui, event);
+		}
+
+		idleDraw(NULL);
+		SDL_RenderPresent(render);
+	}
+	recordIdle("idle_poll_loop", count, idleFrames, IDLE_SECONDS, clock() - cpu);
+
+	cpu = clock();
+	idleFrames = 0;
+	GUI_RequestRedraw(gui);
+	SDL_AddTimer(IDLE_SECONDS * 1000, &idleTimeout, NULL);
+	GUI_Run(gui, &idleEvent, &idleDraw, NULL);
+	recordIdle("idle_gui_run", count, idleFrames, IDLE_SECONDS, clock() - cpu);
+
+	freeButtons(idleButtons, count);
+}
+
+static void printResults(bool csv) {
+	if(csv) {
+		printf("benchmark,components,iterations,ns_per_iteration,ns_per_component,frames,cpu_percent,render_calls\n");
+		for(int i = 0; i < numResults; i++) {
+			printf("%s,%d,%d,%.1f,%.3f,", results[i].name, results[i].count, results[i].iterations, results[i].nsPerIteration, results[i].nsPerComponent);
+
+			if(results[i].frames >= 0)
+				printf("%d,%.2f,", results[i].frames, results[i].cpuPercent);
+			else
+				printf(",,");
+
+			if(results[i].renderCalls >= 0)
+				printf("%d\n", results[i].renderCalls);
+			else
+				printf("\n");
+		}
+
+		return;
+	}
+
+	printf("[\n");
+	for(int i = 0; i < numResults; i++) {
+		printf("  {\"benchmark\": \"%s\", \"components\": %d, \"iterations\": %d, \"ns_per_iteration\": %.1f, \"ns_per_component\": %.3f",
+			results[i].name, results[i].count, results[i].iterations, results[i].nsPerIteration, results[i].nsPerComponent);
+
+		if(results[i].frames >= 0)
+			printf(", \"frames\": %d, \"cpu_percent\": %.2f", results[i].frames, results[i].cpuPercent);
+		if(results[i].renderCalls >= 0)
+			printf(", \"render_calls\": %d", results[i].renderCalls);
+		printf("}%s\n", i + 1 < numResults ? "," : "");
+	}
+	printf("]\n");
+}
+
+int main(int argc, char **argv) {
+	const char *fontPath = "SourceCodePro-Regular.ttf";
+	int maxCount = 100000;
+	bool csv = false;
+
+	for(int i = 1; i < argc; i++) {
+		if(strcmp(argv[i], "--csv") == 0) {
+			csv = true;
+		} else if(strcmp(argv[i], "--max") == 0 && i + 1 < argc) {
+			maxCount = atoi(argv[++i]);
+		} else if(strcmp(argv[i], "--font") == 0 && i + 1 < argc) {
+			fontPath = argv[++i];
+		} else {
+			fprintf(stderr, "usage: %s [--csv] [--max components] [--font path]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	// an explicit SDL_VIDEODRIVER in the environment still wins
+	SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+	if(SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER) != 0) {
+		fprintf(stderr, "could not initialize SDL: %s\n", SDL_GetError());
+		return 1;
+	}
+
+	win = SDL_CreateWindow("bench", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, WIN_WIDTH, WIN_HEIGHT, 0);
+	render = SDL_CreateRenderer(win, -1, SDL_RENDERER_SOFTWARE);
+	if(win == NULL || render == NULL) {
+		fprintf(stderr, "could not create a software renderer: %s\n", SDL_GetError());
+		return 1;
+	}
+
+	gui = GUI_Init(win, render);
+	GUI_SetBatching(gui, true);
+	frequency = SDL_GetPerformanceFrequency();
+
+	font = GUI_NewFont(gui, fontPath, 12);
+	if(font < 0)
+		fprintf(stderr, "could not open %s, skipping text benchmarks\n", fontPath);
+
+	for(int count = 10; count <= maxCount; count *= 10) {
+		benchCreateFree(count);
+		benchEvents(count);
+		benchDraw(count);
+		benchUpdate(count);
+		benchHitTest(count);
+		benchLayout(count);
+		benchListView(count);
+		benchScrollPanel(count);
+	}
+	benchUpdate(maxCount < DENSE_COMPONENTS ? maxCount : DENSE_COMPONENTS);
+	benchBatching(maxCount < BATCHING_COMPONENTS ? maxCount : BATCHING_COMPONENTS);
+	benchIdle(maxCount < IDLE_COMPONENTS ? maxCount : IDLE_COMPONENTS);
+	bool paramOk = benchSliderParam();
+
+	printResults(csv);
+
+	GUI_Quit(gui);
+	SDL_DestroyRenderer(render);
+	SDL_DestroyWindow(win);
+	SDL_Quit();
+	return paramOk ? 0 : 1;
+}
@@ -7,12 +7,12 @@
 SDL_Window *win;
 SDL_Renderer *render;
 GUI_Context *gui;
-SDL_Event event;
 
 GUI_FontID font;
 GUI_Text *header;
 GUI_Button *button;
 GUI_Slider *slider;
+char sliderLabel[32];
 
 void onPress(void *component) {
 	printf("on press\n");
@@ -35,11 +35,28 @@ void sliderOnRelease(void *component) {
 	printf("slider released!!!!\n");
 }
 
+bool onEvent(SDL_Event *event, void *data) {
+	return event->type == SDL_QUIT;
+}
+
+void onDraw(void *data) {
+	SDL_SetRenderDrawColor(render, 0, 0, 0, 0xff);
+	SDL_RenderClear(render);
+
+	GUI_DrawText(gui, header, (WIN_WIDTH - header->width) / 2, 40);
+	GUI_DrawButton(gui, button, 0, 0);
+	GUI_DrawSlider(gui, slider, (WIN_WIDTH - slider->length) / 2, 150);
+
+	snprintf(sliderLabel, sizeof(sliderLabel), "value: %.2f", slider->value);
+	GUI_DrawString(gui, font, sliderLabel, COLOR_WHITE, (WIN_WIDTH - slider->length) / 2, 180);
+}
+
 int main() {
 	SDL_Init(SDL_INIT_VIDEO);
 	win = SDL_CreateWindow("Hello, GUI!", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WIN_WIDTH, WIN_HEIGHT, 0);
 	render = SDL_CreateRenderer(win, -1, 0);
 	gui = GUI_Init(win, render);
+	GUI_SetBatching(gui, true);
 
 	font = GUI_NewFont(gui, "SourceCodePro-Regular.ttf", 24);
 	header = GUI_NewText(gui, font, "Crazy example", COLOR_CYAN);
@@ -54,27 +71,10 @@ int main() {
 	GUI_AddEvent(gui, slider, &sliderOnHold, GUI_SLIDER_ON_HOLD);
 	GUI_AddEvent(gui, slider, &sliderOnRelease, GUI_SLIDER_ON_RELEASE);
 	
-	while(true) {
-		while(SDL_PollEvent(&event)) {
-			if(GUI_Update(gui, event))
-				continue;
-
-			if(event.type == SDL_QUIT) {
-				goto quit;
-			}
-		}
-
-		SDL_SetRenderDrawColor(render, 0, 0, 0, 0xff);
-		SDL_RenderClear(render);
-
-		GUI_DrawText(gui, header, (WIN_WIDTH - header->width) / 2, 40);
-		GUI_DrawButton(gui, button, 0, 0);
-		GUI_DrawSlider(gui, slider, (WIN_WIDTH - slider->length) / 2, 150);
-
-		SDL_RenderPresent(render);
-	}
+	// only redraws when something changed, and sleeps while the window is idle
+	if(GUI_Run(gui, &onEvent, &onDraw, NULL))
+		printf("Waiting for events failed: %s\n", SDL_GetError());
 
-	quit:
 	GUI_Quit(gui);
 	SDL_DestroyRenderer(render);
 	SDL_DestroyWindow(win);
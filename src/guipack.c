@@ -0,0 +1,121 @@
+// Packs files into an asset pack that can be opened with GUI_OpenPack.
+//
+// Layout, all integers little endian:
+//   "GPAK", version, number of entries
+//   per entry: name offset, name length, data offset, data size
+//   names, then file data, each file aligned to 16 bytes
+// Entries are sorted by name so they can be looked up with a binary search.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define PACK_VERSION 1
+#define PACK_HEADER_SIZE 12
+#define PACK_ENTRY_SIZE 16
+#define PACK_ALIGNMENT 16
+
+typedef struct {
+	const char *name;
+	unsigned char *data;
+	uint32_t size;
+	uint32_t nameOffset, dataOffset;
+} Entry;
+
+static int compareEntries(const void *a, const void *b) {
+	return strcmp(((const Entry*) a)->name, ((const Entry*) b)->name);
+}
+
+static void write32(FILE *file, uint32_t value) {
+	unsigned char bytes[4] = {value & 0xff, (value >> 8) & 0xff, (value >> 16) & 0xff, (value >> 24) & 0xff};
+	fwrite(bytes, 1, 4, file);
+}
+
+static unsigned char* readFile(const char *path, uint32_t *size) {
+	FILE *file = fopen(path, "rb");
+	if(file == NULL)
+		return NULL;
+
+	fseek(file, 0, SEEK_END);
+	long length = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	unsigned char *data = (unsigned char*) malloc(length > 0 ? length : 1);
+	if(data == NULL || fread(data, 1, length, file) != (size_t) length) {
+		free(data);
+		fclose(file);
+		return NULL;
+	}
+
+	fclose(file);
+	*size = length;
+	return data;
+}
+
+int main(int argc, char **argv) {
+	if(argc < 3) {
+		fprintf(stderr, "usage: %s <output> <files...>\n", argv[0]);
+		return 1;
+	}
+
+	int count = argc - 2;
+	Entry *entries = (Entry*) calloc(count, sizeof(Entry));
+	if(entries == NULL)
+		return 1;
+
+	for(int i = 0; i < count; i++) {
+		entries[i].name = argv[i + 2];
+		entries[i].data = readFile(argv[i + 2], &entries[i].size);
+
+		if(entries[i].data == NULL) {
+			fprintf(stderr, "could not read %s\n", argv[i + 2]);
+			return 1;
+		}
+	}
+
+	qsort(entries, count, sizeof(Entry), compareEntries);
+
+	uint32_t offset = PACK_HEADER_SIZE + count * PACK_ENTRY_SIZE;
+	for(int i = 0; i < count; i++) {
+		entries[i].nameOffset = offset;
+		offset += strlen(entries[i].name);
+	}
+	for(int i = 0; i < count; i++) {
+		offset = (offset + PACK_ALIGNMENT - 1) & ~(uint32_t) (PACK_ALIGNMENT - 1);
+		entries[i].dataOffset = offset;
+		offset += entries[i].size;
+	}
+
+	FILE *file = fopen(argv[1], "wb");
+	if(file == NULL) {
+		fprintf(stderr, "could not open %s\n", argv[1]);
+		return 1;
+	}
+
+	fwrite("GPAK", 1, 4, file);
+	write32(file, PACK_VERSION);
+	write32(file, count);
+
+	for(int i = 0; i < count; i++) {
+		write32(file, entries[i].nameOffset);
+		write32(file, strlen(entries[i].name));
+		write32(file, entries[i].dataOffset);
+		write32(file, entries[i].size);
+	}
+	for(int i = 0; i < count; i++) {
+		fwrite(entries[i].name, 1, strlen(entries[i].name), file);
+	}
+	for(int i = 0; i < count; i++) {
+		while(ftell(file) < entries[i].dataOffset) {
+			fputc(0, file);
+		}
+
+		fwrite(entries[i].data, 1, entries[i].size, file);
+		free(entries[i].data);
+	}
+
+	fclose(file);
+	free(entries);
+	return 0;
+}
@@ -1,306 +1,2445 @@
 #include "sdl2_gui.h"
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 #include <SDL2/SDL_image.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// GUI_HitTestRects has SSE2 and NEON versions wherever the compiler targets them anyway, and an AVX2
+// version picked at run time on x86 compilers that can build it without -mavx2
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GUI_HIT_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define GUI_HIT_AVX2
+#define GUI_HIT_AVX2_TARGET
+#include <immintrin.h>
+#elif defined(GUI_HIT_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define GUI_HIT_AVX2
+#define GUI_HIT_AVX2_TARGET __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define GUI_HIT_NEON
+#include <arm_neon.h>
+#endif
+
 const char *BMP_FILE_ENDING = ".bmp";
 
-GUI_Context* GUI_Init(SDL_Window *win, SDL_Renderer *render) {
-	if(!SDL_WasInit(SDL_INIT_VIDEO | SDL_INIT_EVENTS))
-		return NULL;
+#define GUI_REGISTRY_MIN_CAPACITY 64
+#define GUI_POOL_ITEMS_PER_SLAB 256
+#define GUI_POOL_ALIGNMENT 16
+#define GUI_GRID_CELL_SIZE 64
+#define GUI_TEXT_HEADROOM 64
+#define GUI_LIST_VIEW_PADDING 4
+#define GUI_LIST_VIEW_WHEEL_ROWS 3
+#define GUI_HIT_CHUNK 256
 
-	if(TTF_Init() < 0) {
-		printf("%s\n", SDL_GetError());
-		return NULL;
-	}
+// frame counters are only collected when the library is built with GUI_ENABLE_STATS
+#ifdef GUI_ENABLE_STATS
+#define GUI_STAT_ADD(context, field, n) ((context)->stats.field += (n))
+#else
+#define GUI_STAT_ADD(context, field, n) ((void) 0)
+#endif
 
-	if(IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG | IMG_INIT_WEBP | IMG_INIT_TIF) < 0) {
-		printf("%s\n", SDL_GetError());
-		return NULL;
-	}
+static void GUI_InternalMarkNodeDirty(GUI_Context *context, GUI_ComponentNode *node);
+static void GUI_InternalSetOwner(GUI_Context *context, void *part, void *owner, bool owned);
+static void GUI_InternalInvalidateLayout(GUI_Context *context, GUI_ComponentNode *node);
+static void GUI_InternalScrollListView(GUI_Context *context, GUI_ListView *list, int scroll, GUI_Slider *source);
+static void GUI_InternalScrollContainer(GUI_Context *context, GUI_Container *container, int scrollX, int scrollY, GUI_Slider *source);
 
-	GUI_Context *context = (GUI_Context*)malloc(sizeof(GUI_Context));
+// Fixed size item pools. Items are carved out of large slabs and recycled through a free list,
+// so nodes stay close together in memory and can all be released at once with GUI_PoolDestroy.
+static void GUI_PoolInit(GUI_Pool *pool, size_t itemSize, int itemsPerSlab) {
+	pool->itemSize = (itemSize + GUI_POOL_ALIGNMENT - 1) & ~(size_t) (GUI_POOL_ALIGNMENT - 1);
+	pool->itemsPerSlab = itemsPerSlab;
+	pool->slabs = NULL;
+	pool->freeList = NULL;
+	pool->numSlabs = 0;
+	pool->numUsed = 0;
+}
+static void* GUI_PoolAlloc(GUI_Pool *pool) {
+	if(pool->freeList == NULL) {
+		char *slab = (char*) malloc(GUI_POOL_ALIGNMENT + pool->itemSize * pool->itemsPerSlab);
+		if(slab == NULL)
+			return NULL;
 
-	context->window = win;
-	context->render = render;
-	SDL_GetWindowSize(win, &context->width, &context->height);
-	context->components = NULL;
-	context->fonts = NULL;
-	context->numFonts = 0;
-	
-	return context;
+		*(void**) slab = pool->slabs;
+		pool->slabs = slab;
+		pool->numSlabs++;
+
+		char *items = slab + GUI_POOL_ALIGNMENT;
+		for(int i = pool->itemsPerSlab - 1; i >= 0; i--) {
+			*(void**) (items + i * pool->itemSize) = pool->freeList;
+			pool->freeList = items + i * pool->itemSize;
+		}
+	}
+
+	void *item = pool->freeList;
+	pool->freeList = *(void**) item;
+	pool->numUsed++;
+	return item;
 }
-void GUI_Quit(GUI_Context *context) {
-	while(context->components != NULL) {
-		GUI_FreeComponent(context, context->components->component);
+static void GUI_PoolFree(GUI_Pool *pool, void *item) {
+	*(void**) item = pool->freeList;
+	pool->freeList = item;
+	pool->numUsed--;
+}
+static void GUI_PoolDestroy(GUI_Pool *pool) {
+	while(pool->slabs != NULL) {
+		void *next = *(void**) pool->slabs;
+		free(pool->slabs);
+		pool->slabs = next;
 	}
 
-	for(int i = 0; i < context->numFonts; i++) {
-		TTF_CloseFont(context->fonts[i]);
+	pool->freeList = NULL;
+	pool->numSlabs = 0;
+	pool->numUsed = 0;
+}
+
+static bool GUI_InternalReserve(void **items, int *capacity, int count, size_t itemSize) {
+	if(count <= *capacity)
+		return false;
+
+	int newCapacity = *capacity == 0 ? 8 : *capacity;
+	while(newCapacity < count) {
+		newCapacity *= 2;
 	}
-	if(context->fonts != NULL)
-		free(context->fonts);
 
-	TTF_Quit();
-	IMG_Quit();
+	void *newItems = realloc(*items, newCapacity * itemSize);
+	if(newItems == NULL)
+		return true;
 
-	free(context);
+	*items = newItems;
+	*capacity = newCapacity;
+	return false;
 }
 
-void GUI_SerializeComponent(GUI_Context *context, void *component, GUI_ComponentType type) {
-	GUI_ComponentNode **node = &context->components;
-	GUI_ComponentNode *prev = NULL;
-	
-	while(*node != NULL) {
-		prev = *node;
-		node = &(*node)->next;
+// Uniform grid over the window used for hit-testing. Every drawn button and slider is listed in
+// each cell its input area overlaps, so a pointer event only has to look at a single cell. Cells list
+// the components' slots in the hot store rather than their nodes.
+static void GUI_GridInit(GUI_Grid *grid, int width, int height, int cellSize) {
+	grid->cellSize = cellSize;
+	grid->columns = width / cellSize + 1;
+	grid->rows = height / cellSize + 1;
+	grid->cells = (GUI_GridCell*) calloc(grid->columns * grid->rows, sizeof(GUI_GridCell));
+	if(grid->cells == NULL) {
+		grid->columns = 0;
+		grid->rows = 0;
+	}
+}
+static void GUI_GridDestroy(GUI_Grid *grid) {
+	for(int i = 0; i < grid->columns * grid->rows; i++) {
+		if(grid->cells[i].items != NULL)
+			free(grid->cells[i].items);
+		if(grid->cells[i].packed != NULL)
+			free(grid->cells[i].packed);
 	}
 
-	*node = (GUI_ComponentNode*) malloc(sizeof(GUI_ComponentNode));
-	(*node)->component = component;
-	(*node)->type = type;
-	(*node)->events = NULL;
-	(*node)->prev = prev;
-	(*node)->next = NULL;
+	if(grid->cells != NULL)
+		free(grid->cells);
+	grid->cells = NULL;
 }
-void GUI_FreeComponent(GUI_Context *context, void *component) {
-	GUI_ComponentNode *node = context->components;
+static int GUI_GridIndex(int value, int cellSize, int count) {
+	int index = value < 0 ? 0 : value / cellSize;
+	return index >= count ? count - 1 : index;
+}
+static GUI_GridCell* GUI_GridCellAt(GUI_Grid *grid, int x, int y) {
+	if(grid->cells == NULL)
+		return NULL;
+
+	return &grid->cells[GUI_GridIndex(y, grid->cellSize, grid->rows) * grid->columns + GUI_GridIndex(x, grid->cellSize, grid->columns)];
+}
+static void GUI_GridRemove(GUI_Grid *grid, GUI_ComponentNode *node) {
+	if(node->gridX0 < 0)
+		return;
+
+	for(int row = node->gridY0; row <= node->gridY1; row++) {
+		for(int column = node->gridX0; column <= node->gridX1; column++) {
+			GUI_GridCell *cell = &grid->cells[row * grid->columns + column];
 
-	while(node != NULL && node->component != component) {
-		node = node->next;
+			for(int i = 0; i < cell->count; i++) {
+				if(cell->items[i] == node->hotIndex) {
+					cell->items[i] = cell->items[--cell->count];
+					cell->stale = true;
+					break;
+				}
+			}
+		}
 	}
 
-	if(node == NULL)
+	node->gridX0 = -1;
+}
+static void GUI_GridMove(GUI_Grid *grid, GUI_ComponentNode *node, int x0, int y0, int x1, int y1) {
+	if(grid->cells == NULL)
 		return;
 
-	GUI_ClearEvents(context, component);
+	int column0 = GUI_GridIndex(x0, grid->cellSize, grid->columns);
+	int row0 = GUI_GridIndex(y0, grid->cellSize, grid->rows);
+	int column1 = GUI_GridIndex(x1, grid->cellSize, grid->columns);
+	int row1 = GUI_GridIndex(y1, grid->cellSize, grid->rows);
 
-	if(node->prev == NULL) {
-		context->components = node->next;
-		if(context->components != NULL) {
-			context->components->prev = NULL;
+	if(node->gridX0 == column0 && node->gridY0 == row0 && node->gridX1 == column1 && node->gridY1 == row1)
+		return;
+
+	GUI_GridRemove(grid, node);
+
+	for(int row = row0; row <= row1; row++) {
+		for(int column = column0; column <= column1; column++) {
+			GUI_GridCell *cell = &grid->cells[row * grid->columns + column];
+
+			if(GUI_InternalReserve((void**) &cell->items, &cell->capacity, cell->count + 1, sizeof(int)))
+				continue;
+			cell->items[cell->count++] = node->hotIndex;
+			cell->stale = true;
 		}
 	}
-	else {
-		node->prev->next = node->next;
-	}
 
+	node->gridX0 = column0;
+	node->gridY0 = row0;
+	node->gridX1 = column1;
+	node->gridY1 = row1;
+}
+// cells keep a packed copy of their components' input areas for GUI_HitTestRects, which is only
+// copied again once something in the cell has changed
+static void GUI_GridTouch(GUI_Grid *grid, GUI_ComponentNode *node) {
+	if(node->gridX0 < 0)
+		return;
 
-	if(node->type == GUI_COMPONENT_TEXT)
-		GUI_FreeText(context, (GUI_Text*) component);
-	else if(node->type == GUI_COMPONENT_IMAGE)
-		GUI_FreeImage(context, (GUI_Image*) component);
-	else if(node->type == GUI_COMPONENT_BUTTON)
-		GUI_FreeButton(context, (GUI_Button*) component);
-
-	free(node);
+	for(int row = node->gridY0; row <= node->gridY1; row++) {
+		for(int column = node->gridX0; column <= node->gridX1; column++) {
+			grid->cells[row * grid->columns + column].stale = true;
+		}
+	}
 }
-GUI_FontID GUI_NewFont(GUI_Context *context, const char *path, int ptsize) {
-	TTF_Font* font = TTF_OpenFont(path, ptsize);
-	if(font == NULL)
-		return -1;
 
-	TTF_Font **newFonts = (TTF_Font**) calloc(context->numFonts + 1, sizeof(TTF_Font*));
-	
-	for(int i = 0; i < context->numFonts; i++) {
-		newFonts[i] = context->fonts[i];
+// Buttons, sliders and list views each own a slot in the hot store, which keeps what hit-testing needs
+// in parallel arrays: the area the component reacts to, its flags and the last update that visited it.
+// GUI_Update only reads these arrays until it finds a component under the pointer. Slots are kept dense
+// by moving the last one into a freed slot.
+static bool GUI_HotReserve(GUI_HotStore *hot, int count) {
+	void **arrays[] = {(void**) &hot->nodes, (void**) &hot->x0, (void**) &hot->y0, (void**) &hot->x1, (void**) &hot->y1, (void**) &hot->flags, (void**) &hot->visited};
+	size_t sizes[] = {sizeof(GUI_ComponentNode*), sizeof(int), sizeof(int), sizeof(int), sizeof(int), sizeof(Uint8), sizeof(unsigned int)};
+	int capacity = hot->capacity;
+
+	for(int i = 0; i < (int) (sizeof(arrays) / sizeof(arrays[0])); i++) {
+		capacity = hot->capacity;
+		if(GUI_InternalReserve(arrays[i], &capacity, count, sizes[i]))
+			return true;
 	}
 
-	if(context->fonts != NULL)
-		free(context->fonts);
+	hot->capacity = capacity;
+	return false;
+}
+static void GUI_HotDestroy(GUI_HotStore *hot) {
+	void *arrays[] = {hot->nodes, hot->x0, hot->y0, hot->x1, hot->y1, hot->flags, hot->visited};
 
-	context->fonts = newFonts;
-	context->fonts[context->numFonts] = font;
-	context->numFonts++;
+	for(int i = 0; i < (int) (sizeof(arrays) / sizeof(arrays[0])); i++) {
+		if(arrays[i] != NULL)
+			free(arrays[i]);
+	}
+}
+static void GUI_HotAdd(GUI_HotStore *hot, GUI_ComponentNode *node) {
+	int index = hot->count++;
 
-	return context->numFonts - 1;
+	hot->nodes[index] = node;
+	hot->x0[index] = 0;
+	hot->y0[index] = 0;
+	hot->x1[index] = -1;
+	hot->y1[index] = -1;
+	hot->flags[index] = 0;
+	hot->visited[index] = 0;
+	node->hotIndex = index;
 }
+static void GUI_HotRemove(GUI_Context *context, GUI_ComponentNode *node) {
+	GUI_HotStore *hot = &context->hot;
+	GUI_Grid *grid = &context->grid;
+	int index = node->hotIndex, last = hot->count - 1;
+	if(index < 0)
+		return;
 
-GUI_Text* GUI_NewTextBg(GUI_Context *context, GUI_FontID font, const char *str, SDL_Color fg, SDL_Color bg) {
-	GUI_Text *text = (GUI_Text*) malloc(sizeof(GUI_Text));
+	node->hotIndex = -1;
+	hot->count--;
+	if(index == last)
+		return;
 
-	SDL_Surface *surface = TTF_RenderText_Shaded_Wrapped(context->fonts[font], str, fg, bg, 0);
-	if(surface == NULL)
-		return NULL;
+	GUI_ComponentNode *moved = hot->nodes[last];
+	hot->nodes[index] = moved;
+	hot->x0[index] = hot->x0[last];
+	hot->y0[index] = hot->y0[last];
+	hot->x1[index] = hot->x1[last];
+	hot->y1[index] = hot->y1[last];
+	hot->flags[index] = hot->flags[last];
+	hot->visited[index] = hot->visited[last];
+	moved->hotIndex = index;
 
-	text->texture = SDL_CreateTextureFromSurface(context->render, surface);
-	SDL_FreeSurface(surface);
+	// the drawn list and the cells listing the moved slot have to follow it
+	if((hot->flags[index] & GUI_HOT_ON_SCREEN) && GUI_InternalReserve((void**) &context->drawn, &context->drawnCapacity, context->numDrawn + 1, sizeof(int)))
+		hot->flags[index] &= (Uint8) ~GUI_HOT_ON_SCREEN;
+	else if(hot->flags[index] & GUI_HOT_ON_SCREEN)
+		context->drawn[context->numDrawn++] = index;
 
-	if(text->texture == NULL)
-		return NULL;
+	if(moved->gridX0 < 0)
+		return;
 
-	TTF_SizeText(context->fonts[font], str, &text->width, &text->height);
+	for(int row = moved->gridY0; row <= moved->gridY1; row++) {
+		for(int column = moved->gridX0; column <= moved->gridX1; column++) {
+			GUI_GridCell *cell = &grid->cells[row * grid->columns + column];
 
-	GUI_SerializeComponent(context, text, GUI_COMPONENT_TEXT);
-	return text;
+			for(int i = 0; i < cell->count; i++) {
+				if(cell->items[i] == last) {
+					cell->items[i] = index;
+					cell->stale = true;
+					break;
+				}
+			}
+		}
+	}
 }
-GUI_Text* GUI_NewText(GUI_Context *context, GUI_FontID font, const char *str, SDL_Color fg) {
-	GUI_Text *text = (GUI_Text*) malloc(sizeof(GUI_Text));
+static void GUI_HotMove(GUI_Context *context, GUI_ComponentNode *node, int x0, int y0, int x1, int y1) {
+	GUI_HotStore *hot = &context->hot;
+	int index = node->hotIndex;
 
-	SDL_Surface *surface = TTF_RenderText_Blended_Wrapped(context->fonts[font], str, fg, 0);
-	if(surface == NULL)
-		return NULL;
+	if(hot->x0[index] != x0 || hot->y0[index] != y0 || hot->x1[index] != x1 || hot->y1[index] != y1) {
+		hot->x0[index] = x0;
+		hot->y0[index] = y0;
+		hot->x1[index] = x1;
+		hot->y1[index] = y1;
+		GUI_GridTouch(&context->grid, node);
+	}
 
-	text->texture = SDL_CreateTextureFromSurface(context->render, surface);
-	SDL_FreeSurface(surface);
+	GUI_GridMove(&context->grid, node, x0, y0, x1, y1);
+}
+static bool GUI_HotPackCell(GUI_HotStore *hot, GUI_GridCell *cell) {
+	if(GUI_InternalReserve((void**) &cell->packed, &cell->packedCapacity, cell->count * 4, sizeof(int)))
+		return true;
 
-	if(text->texture == NULL)
-		return NULL;
+	int *x0 = cell->packed, *y0 = x0 + cell->count, *x1 = y0 + cell->count, *y1 = x1 + cell->count;
+	for(int i = 0; i < cell->count; i++) {
+		x0[i] = hot->x0[cell->items[i]];
+		y0[i] = hot->y0[cell->items[i]];
+		x1[i] = hot->x1[cell->items[i]];
+		y1[i] = hot->y1[cell->items[i]];
+	}
 
-	TTF_SizeText(context->fonts[font], str, &text->width, &text->height);
+	cell->stale = false;
+	return false;
+}
+static void GUI_HotSetFlag(GUI_HotStore *hot, GUI_ComponentNode *node, Uint8 flag, bool set) {
+	if(node->hotIndex < 0)
+		return;
 
-	GUI_SerializeComponent(context, text, GUI_COMPONENT_TEXT);
-	return text;
+	if(set)
+		hot->flags[node->hotIndex] |= flag;
+	else
+		hot->flags[node->hotIndex] &= (Uint8) ~flag;
 }
-void GUI_FreeText(GUI_Context *context, GUI_Text *text) {
-	SDL_DestroyTexture(text->texture);
-	free(text);
+
+// The slots of components drawn since the last GUI_Update are kept in the drawn list so their on screen
+// flags can be cleared without visiting every component. A slot can be listed more than once, or after
+// its component was freed, which only means a flag is cleared that already was. Components with a hover, press or hold in progress are kept
+// in the active list, because they have to see events that happen outside of their own area.
+static void GUI_InternalListAdd(GUI_ComponentNode ***list, int *count, int *capacity, int *index, GUI_ComponentNode *node) {
+	if(*index >= 0 || GUI_InternalReserve((void**) list, capacity, *count + 1, sizeof(GUI_ComponentNode*)))
+		return;
+
+	*index = *count;
+	(*list)[(*count)++] = node;
 }
-void GUI_DrawText(GUI_Context *context, GUI_Text *text, int x, int y) {
-	SDL_Rect rect = (SDL_Rect) {x, y, text->width, text->height};
-	SDL_RenderCopy(context->render, text->texture, NULL, &rect);
+static void GUI_InternalSetActive(GUI_Context *context, GUI_ComponentNode *node, bool active) {
+	if(active) {
+		GUI_InternalListAdd(&context->active, &context->numActive, &context->activeCapacity, &node->activeIndex, node);
+	}
+	else if(node->activeIndex >= 0) {
+		GUI_ComponentNode *last = context->active[--context->numActive];
+		context->active[node->activeIndex] = last;
+		last->activeIndex = node->activeIndex;
+		node->activeIndex = -1;
+	}
 }
+// hiding a container hides everything inside it
+static bool GUI_InternalNodeHidden(GUI_ComponentNode *node) {
+	for(; node != NULL; node = node->parent) {
+		if(node->hidden)
+			return true;
+	}
 
-GUI_Image* GUI_NewImage(GUI_Context *context, const char *path, float xScale, float yScale) {
-	GUI_Image* image = (GUI_Image*) malloc(sizeof(GUI_Image));
-	bool isBmp = true;
-	int len = 0;
+	return false;
+}
+static bool GUI_InternalIsHidden(GUI_Context *context, void *component) {
+	GUI_ComponentNode *node = GUI_FindComponent(context, component);
+	return node != NULL && GUI_InternalNodeHidden(node);
+}
+// drawing functions look their node up once, and pass it here after checking it isn't hidden
+static void GUI_InternalMarkDrawn(GUI_Context *context, GUI_ComponentNode *node, int x0, int y0, int x1, int y1) {
+	if(node == NULL)
+		return;
 
-	while(path[len] != 0) {
-		len++;
+	GUI_HotStore *hot = &context->hot;
+	if(!(hot->flags[node->hotIndex] & GUI_HOT_ON_SCREEN) && !GUI_InternalReserve((void**) &context->drawn, &context->drawnCapacity, context->numDrawn + 1, sizeof(int))) {
+		hot->flags[node->hotIndex] |= GUI_HOT_ON_SCREEN;
+		context->drawn[context->numDrawn++] = node->hotIndex;
 	}
 
-	for(int i = 0; i < 4; i++) {
-		if(path[len - 4 + i] != BMP_FILE_ENDING[i]) {
-			isBmp = false;
-			break;
-		}
+	GUI_HotMove(context, node, x0, y0, x1, y1);
+}
+static void GUI_InternalClearDrawn(GUI_Context *context) {
+	GUI_HotStore *hot = &context->hot;
+
+	for(int i = 0; i < context->numDrawn; i++) {
+		if(context->drawn[i] < hot->count)
+			hot->flags[context->drawn[i]] &= (Uint8) ~GUI_HOT_ON_SCREEN;
 	}
 
-	SDL_Surface *surface;
-	if(isBmp)
-		surface = SDL_LoadBMP(path);
-	else
-		surface = IMG_Load(path);
+	context->numDrawn = 0;
+}
+static void GUI_InternalForgetNode(GUI_Context *context, GUI_ComponentNode *node) {
+	GUI_GridRemove(&context->grid, node);
+	GUI_InternalSetActive(context, node, false);
+	GUI_HotSetFlag(&context->hot, node, GUI_HOT_ON_SCREEN, false);
+}
 
-	if(surface == NULL)
-		return NULL;
+// Everything the library draws is recorded as quads in the draw list. Consecutive quads that use the
+// same texture (or no texture, for solid rectangles) share a command, and each command is issued with
+// a single SDL_RenderGeometry call, so a screen of plain buttons can be drawn with one renderer call.
+static void GUI_InternalPushQuad(GUI_Context *context, SDL_Texture *texture, float u0, float v0, float u1, float v1, SDL_Rect *dst, SDL_Color color) {
+	GUI_DrawList *list = &context->drawList;
 
-	SDL_Texture *texture = SDL_CreateTextureFromSurface(context->render, surface);
-	SDL_FreeSurface(surface);
-	if(texture == NULL)
-		return NULL;
+	if(dst->w <= 0 || dst->h <= 0)
+		return;
+	if(GUI_InternalReserve((void**) &list->vertices, &list->verticesCapacity, list->numVertices + 4, sizeof(SDL_Vertex)))
+		return;
+	if(GUI_InternalReserve((void**) &list->indices, &list->indicesCapacity, list->numIndices + 6, sizeof(int)))
+		return;
 
-	image->texture = texture;
+	GUI_DrawCommand *command = list->numCommands > 0 ? &list->commands[list->numCommands - 1] : NULL;
+	if(command == NULL || command->texture != texture) {
+		if(GUI_InternalReserve((void**) &list->commands, &list->commandsCapacity, list->numCommands + 1, sizeof(GUI_DrawCommand)))
+			return;
 
-	SDL_QueryTexture(texture, NULL, NULL, &image->width, &image->height);
-	image->width *= xScale;
-	image->height *= yScale;
+		command = &list->commands[list->numCommands++];
+		command->texture = texture;
+		command->first = list->numIndices;
+		command->count = 0;
+	}
 
-	GUI_SerializeComponent(context, image, GUI_COMPONENT_IMAGE);
-	return image;
+	SDL_Vertex *vertex = &list->vertices[list->numVertices];
+	vertex[0] = (SDL_Vertex) {{dst->x, dst->y}, color, {u0, v0}};
+	vertex[1] = (SDL_Vertex) {{dst->x + dst->w, dst->y}, color, {u1, v0}};
+	vertex[2] = (SDL_Vertex) {{dst->x + dst->w, dst->y + dst->h}, color, {u1, v1}};
+	vertex[3] = (SDL_Vertex) {{dst->x, dst->y + dst->h}, color, {u0, v1}};
+
+	int *index = &list->indices[list->numIndices];
+	int first = list->numVertices;
+	index[0] = first;
+	index[1] = first + 1;
+	index[2] = first + 2;
+	index[3] = first;
+	index[4] = first + 2;
+	index[5] = first + 3;
+
+	list->numVertices += 4;
+	list->numIndices += 6;
+	command->count += 6;
 }
-void GUI_FreeImage(GUI_Context *context, GUI_Image *image) {
-	SDL_DestroyTexture(image->texture);
-	free(image);
+static void GUI_InternalPushRect(GUI_Context *context, SDL_Rect *rect, SDL_Color color) {
+	GUI_InternalPushQuad(context, NULL, 0, 0, 0, 0, rect, color);
 }
-void GUI_DrawImage(GUI_Context *context, GUI_Image *image, int x, int y) {
-	SDL_Rect rect = (SDL_Rect) {x, y, image->width, image->height};
-	SDL_RenderCopy(context->render, image->texture, NULL, &rect);
+static void GUI_InternalPushTexture(GUI_Context *context, SDL_Texture *texture, SDL_Rect *src, int textureWidth, int textureHeight, SDL_Rect *dst) {
+	if(src == NULL) {
+		GUI_InternalPushQuad(context, texture, 0, 0, 1, 1, dst, COLOR_WHITE);
+		return;
+	}
+
+	GUI_InternalPushQuad(context, texture, (float) src->x / textureWidth, (float) src->y / textureHeight, (float) (src->x + src->w) / textureWidth, (float) (src->y + src->h) / textureHeight, dst, COLOR_WHITE);
+}
+static void GUI_InternalEndDraw(GUI_Context *context) {
+	if(!context->drawList.batching)
+		GUI_Flush(context);
 }
+void GUI_GetFrameStats(GUI_Context *context, GUI_FrameStats *stats) {
+	*stats = context->stats;
+	memset(&context->stats, 0, sizeof(GUI_FrameStats));
+}
+void GUI_SetBatching(GUI_Context *context, bool batching) {
+	if(!batching)
+		GUI_Flush(context);
 
-GUI_Button* GUI_NewButton(GUI_Context *context, int width, int height, int borderWidth, SDL_Color fillColor, SDL_Color borderColor, GUI_Text *textContent, GUI_Image *imageContent) {
-	GUI_Button *button = (GUI_Button*) malloc(sizeof(GUI_Button));
+	context->drawList.batching = batching;
+}
+void GUI_Flush(GUI_Context *context) {
+	GUI_DrawList *list = &context->drawList;
 
-	button->textContent = textContent;
-	button->imageContent = imageContent;
-	button->x = -1;
-	button->y = -1;
-	button->width = width;
-	button->height = height;
-	button->borderWidth = borderWidth;
-	button->fillColor = fillColor;
-	button->borderColor = borderColor;
-	button->inside = false;
-	button->pressed = false;
-	button->onScreen = false;
+	for(int i = 0; i < list->numCommands; i++) {
+		SDL_RenderGeometry(context->render, list->commands[i].texture, list->vertices, list->numVertices, list->indices + list->commands[i].first, list->commands[i].count);
+		GUI_STAT_ADD(context, renderCalls, 1);
+		GUI_STAT_ADD(context, textureBinds, list->commands[i].texture != NULL && (i == 0 || list->commands[i].texture != list->commands[i - 1].texture));
+	}
 
-	GUI_SerializeComponent(context, button, GUI_COMPONENT_BUTTON);
-	return button;
+	list->numCommands = 0;
+	list->numVertices = 0;
+	list->numIndices = 0;
 }
-void GUI_FreeButton(GUI_Context *context, GUI_Button *button) {
-	free(button);
+// The draw list only holds pointers to textures until it's flushed, so whatever was recorded has to be
+// drawn before one of them is destroyed or has its pixels overwritten.
+static void GUI_InternalFlushPending(GUI_Context *context) {
+	if(context->drawList.numCommands > 0)
+		GUI_Flush(context);
+}
+static void GUI_InternalDestroyTexture(GUI_Context *context, SDL_Texture *texture) {
+	GUI_InternalFlushPending(context);
+	SDL_DestroyTexture(texture);
+	GUI_STAT_ADD(context, texturesDestroyed, 1);
 }
-void GUI_DrawButton(GUI_Context *context, GUI_Button *button, int x, int y) {
-	button->x = x;
-	button->y = y;
-	button->onScreen = true;
 
-	SDL_Rect rect = (SDL_Rect) {x, y, button->width, button->height};
+// Atlas pages are packed with simple shelves: glyphs or images are placed left to right on the current
+// shelf, and a new shelf is started below it once a row is full. A page is left untouched if the
+// rectangle doesn't fit, so a smaller one can still go on the current shelf.
+static bool GUI_InternalAtlasPack(GUI_AtlasPage *page, int w, int h, SDL_Rect *rect) {
+	int shelfX = page->shelfX, shelfY = page->shelfY, shelfHeight = page->shelfHeight;
+	if(shelfX + w > page->width) {
+		shelfX = 0;
+		shelfY += shelfHeight + 1;
+		shelfHeight = 0;
+	}
 
-	SDL_SetRenderDrawColor(context->render, button->fillColor.r, button->fillColor.g, button->fillColor.b, button->fillColor.a);
-	SDL_RenderFillRect(context->render, &rect);
+	if(w > page->width || shelfY + h > page->height)
+		return true;
 
-	SDL_SetRenderDrawColor(context->render, button->borderColor.r, button->borderColor.g, button->borderColor.b, button->borderColor.a);
-	for(int i = 0; i < button->borderWidth; i++) {
-		SDL_RenderDrawRect(context->render, &rect);
-		rect.x++;
-		rect.y++;
-		rect.w -= 2;
-		rect.h -= 2;
+	*rect = (SDL_Rect) {shelfX, shelfY, w, h};
+	page->shelfX = shelfX + w + 1;
+	page->shelfY = shelfY;
+	page->shelfHeight = h > shelfHeight ? h : shelfHeight;
+	return false;
+}
+static int GUI_InternalAtlasAdd(GUI_Context *context, GUI_AtlasPage **pages, int *numPages, SDL_Surface *surface, SDL_Rect *rect) {
+	int page = 0;
+	while(page < *numPages && GUI_InternalAtlasPack(&(*pages)[page], surface->w, surface->h, rect)) {
+		page++;
 	}
 
-	int yPadding = 0;
-	int numContent = 1;
+	if(page == *numPages) {
+		if(surface->w > GUI_ATLAS_SIZE || surface->h > GUI_ATLAS_SIZE)
+			return -1;
 
-	if(button->textContent != NULL) {
-		yPadding += button->textContent->height;
-		numContent++;
-	}
-	if(button->imageContent != NULL) {
-		yPadding += button->imageContent->height;
-		numContent++;
+		GUI_AtlasPage *newPages = (GUI_AtlasPage*) realloc(*pages, (*numPages + 1) * sizeof(GUI_AtlasPage));
+		if(newPages == NULL)
+			return -1;
+		*pages = newPages;
+
+		GUI_AtlasPage *newPage = &newPages[*numPages];
+		memset(newPage, 0, sizeof(GUI_AtlasPage));
+		newPage->width = GUI_ATLAS_SIZE;
+		newPage->height = GUI_ATLAS_SIZE;
+		newPage->texture = SDL_CreateTexture(context->render, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, newPage->width, newPage->height);
+		if(newPage->texture == NULL)
+			return -1;
+		GUI_STAT_ADD(context, texturesCreated, 1);
+
+		SDL_SetTextureBlendMode(newPage->texture, SDL_BLENDMODE_BLEND);
+		page = (*numPages)++;
+		GUI_InternalAtlasPack(newPage, surface->w, surface->h, rect);
 	}
 
-	yPadding = (button->height - yPadding) / numContent;
+	SDL_Surface *converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+	if(converted == NULL)
+		return -1;
 
-	if(button->imageContent != NULL) {
-		GUI_DrawImage(context, button->imageContent, x + (button->width - button->imageContent->width) / 2, y + yPadding);
-		y += yPadding + button->imageContent->height;
+	SDL_UpdateTexture((*pages)[page].texture, rect, converted->pixels, converted->pitch);
+	SDL_FreeSurface(converted);
+	return page;
+}
+// Image pages count the images packed into them. Shelves can't free single rectangles, so a page
+// is only reused once every image on it has been released.
+static void GUI_InternalReleaseAtlasImage(GUI_Context *context, int page) {
+	GUI_AtlasPage *atlasPage = &context->imagePages[page];
+	if(--atlasPage->numImages > 0)
+		return;
+
+	// anything still recorded from the page has to be drawn before its pixels get overwritten
+	GUI_InternalFlushPending(context);
+	atlasPage->shelfX = 0;
+	atlasPage->shelfY = 0;
+	atlasPage->shelfHeight = 0;
+}
+static void GUI_InternalDestroyPages(GUI_AtlasPage *pages, int numPages) {
+	for(int i = 0; i < numPages; i++) {
+		SDL_DestroyTexture(pages[i].texture);
 	}
-	if(button->textContent != NULL) {
-		GUI_DrawText(context, button->textContent, x + (button->width - button->textContent->width) / 2, y + yPadding);
+
+	if(pages != NULL)
+		free(pages);
+}
+
+// Fonts loaded from a baked glyph file are only opened once something needs FreeType,
+// like a glyph that wasn't baked or a text component.
+static TTF_Font* GUI_InternalFont(GUI_Context *context, GUI_FontID font) {
+	GUI_GlyphAtlas *atlas = &context->atlases[font];
+
+	if(context->fonts[font] == NULL && atlas->path != NULL) {
+		context->fonts[font] = TTF_OpenFont(atlas->path, atlas->ptsize);
+
+		// only tried once, so a missing font file doesn't hit the disk on every glyph
+		free(atlas->path);
+		atlas->path = NULL;
 	}
+
+	return context->fonts[font];
 }
 
-void GUI_InternalSliderEvent(void *component) {
-	GUI_Slider *slider = (GUI_Slider*)component;
-	int mouseX, mouseY;
-	SDL_GetMouseState(&mouseX, &mouseY);
-	
-	if(slider->vertical) {
-		slider->value = 1 - ((float)(mouseY - slider->y)) / slider->length;
+// Text textures are shared through a cache keyed by everything that affects the rendered pixels.
+// Entries nobody references anymore stay in an LRU list and are only destroyed once the cache
+// grows past its byte budget, so recreating a recently freed label is still a cache hit.
+static Uint32 GUI_InternalHashText(GUI_FontID font, const char *str, SDL_Color fg, SDL_Color bg, bool shaded) {
+	Uint32 hash = 2166136261u;
+	Uint8 key[13] = {
+		font & 0xff, (font >> 8) & 0xff, (font >> 16) & 0xff, (font >> 24) & 0xff,
+		fg.r, fg.g, fg.b, fg.a, bg.r, bg.g, bg.b, bg.a, shaded
+	};
+
+	for(int i = 0; i < 13; i++) {
+		hash = (hash ^ key[i]) * 16777619u;
 	}
-	else {
-		slider->value = ((float)(mouseX - slider->x)) / slider->length;
+	for(const char *c = str; *c != 0; c++) {
+		hash = (hash ^ (Uint8) *c) * 16777619u;
 	}
 
-	if(slider->value > 1.0)
-		slider->value = 1.0;
-	else if(slider->value < 0.0)
-		slider->value = 0.0;
+	return hash;
 }
+static bool GUI_InternalColorsEqual(SDL_Color a, SDL_Color b) {
+	return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+static void GUI_InternalLruUnlink(GUI_TextCache *cache, GUI_TextCacheEntry *entry) {
+	if(entry->lruPrev != NULL)
+		entry->lruPrev->lruNext = entry->lruNext;
+	else
+		cache->lruHead = entry->lruNext;
 
-GUI_Slider* GUI_NewSlider(GUI_Context *context, GUI_Button *incrementButton, GUI_Button *decrementButton, float buttonValueMod, int width, int length, bool vertical, SDL_Color sliderColor, SDL_Color handleColor) {
-	GUI_Slider *slider = (GUI_Slider*) malloc(sizeof(GUI_Slider));
+	if(entry->lruNext != NULL)
+		entry->lruNext->lruPrev = entry->lruPrev;
+	else
+		cache->lruTail = entry->lruPrev;
 
-	if(incrementButton != NULL && decrementButton != NULL) {
-		slider->inc = incrementButton;
-		slider->dec = decrementButton;
+	entry->lruPrev = NULL;
+	entry->lruNext = NULL;
+}
+static void GUI_InternalTextCacheDestroyEntry(GUI_Context *context, GUI_TextCacheEntry *entry) {
+	GUI_TextCache *cache = &context->textCache;
+	GUI_TextCacheEntry **link = &cache->buckets[entry->hash & (cache->numBuckets - 1)];
+	while(*link != entry) {
+		link = &(*link)->hashNext;
 	}
-	else {
-		slider->inc = NULL;
-		slider->dec = NULL;
+	*link = entry->hashNext;
+
+	cache->bytes -= entry->bytes;
+	cache->numEntries--;
+	GUI_InternalDestroyTexture(context, entry->texture);
+	free(entry->str);
+	free(entry);
+}
+static void GUI_InternalTextCacheTrim(GUI_Context *context) {
+	GUI_TextCache *cache = &context->textCache;
+
+	while(cache->bytes > cache->budget && cache->lruHead != NULL) {
+		GUI_TextCacheEntry *entry = cache->lruHead;
+
+		GUI_InternalLruUnlink(cache, entry);
+		GUI_InternalTextCacheDestroyEntry(context, entry);
+		cache->evictions++;
+	}
+}
+static bool GUI_InternalTextCacheGrow(GUI_TextCache *cache) {
+	int numBuckets = cache->numBuckets == 0 ? 64 : cache->numBuckets * 2;
+	GUI_TextCacheEntry **buckets = (GUI_TextCacheEntry**) calloc(numBuckets, sizeof(GUI_TextCacheEntry*));
+	if(buckets == NULL)
+		return true;
+
+	for(int i = 0; i < cache->numBuckets; i++) {
+		GUI_TextCacheEntry *entry = cache->buckets[i];
+
+		while(entry != NULL) {
+			GUI_TextCacheEntry *next = entry->hashNext;
+			entry->hashNext = buckets[entry->hash & (numBuckets - 1)];
+			buckets[entry->hash & (numBuckets - 1)] = entry;
+			entry = next;
+		}
+	}
+
+	if(cache->buckets != NULL)
+		free(cache->buckets);
+
+	cache->buckets = buckets;
+	cache->numBuckets = numBuckets;
+	return false;
+}
+static void GUI_InternalTextCacheRelease(GUI_Context *context, GUI_TextCacheEntry *entry) {
+	GUI_TextCache *cache = &context->textCache;
+
+	if(--entry->refCount > 0)
+		return;
+
+	entry->lruPrev = cache->lruTail;
+	if(cache->lruTail != NULL)
+		cache->lruTail->lruNext = entry;
+	else
+		cache->lruHead = entry;
+	cache->lruTail = entry;
+
+	GUI_InternalTextCacheTrim(context);
+}
+static void GUI_InternalTextCacheDestroy(GUI_Context *context) {
+	GUI_TextCache *cache = &context->textCache;
+
+	for(int i = 0; i < cache->numBuckets; i++) {
+		while(cache->buckets[i] != NULL) {
+			GUI_InternalTextCacheDestroyEntry(context, cache->buckets[i]);
+		}
+	}
+
+	if(cache->buckets != NULL)
+		free(cache->buckets);
+	cache->buckets = NULL;
+	cache->numBuckets = 0;
+}
+static GUI_TextCacheEntry* GUI_InternalTextCacheAcquire(GUI_Context *context, GUI_FontID font, const char *str, SDL_Color fg, SDL_Color bg, bool shaded) {
+	GUI_TextCache *cache = &context->textCache;
+	Uint32 hash = GUI_InternalHashText(font, str, fg, bg, shaded);
+
+	if(cache->numBuckets > 0) {
+		GUI_TextCacheEntry *entry = cache->buckets[hash & (cache->numBuckets - 1)];
+
+		while(entry != NULL) {
+			if(entry->hash == hash && entry->font == font && entry->shaded == shaded && GUI_InternalColorsEqual(entry->fg, fg) && GUI_InternalColorsEqual(entry->bg, bg) && strcmp(entry->str, str) == 0) {
+				if(entry->refCount++ == 0)
+					GUI_InternalLruUnlink(cache, entry);
+
+				cache->hits++;
+				return entry;
+			}
+
+			entry = entry->hashNext;
+		}
+	}
+
+	cache->misses++;
+	if(cache->numEntries >= cache->numBuckets && GUI_InternalTextCacheGrow(cache))
+		return NULL;
+
+	SDL_Surface *surface;
+	if(shaded)
+		surface = TTF_RenderText_Shaded_Wrapped(GUI_InternalFont(context, font), str, fg, bg, 0);
+	else
+		surface = TTF_RenderText_Blended_Wrapped(GUI_InternalFont(context, font), str, fg, 0);
+
+	if(surface == NULL)
+		return NULL;
+
+	GUI_TextCacheEntry *entry = (GUI_TextCacheEntry*) calloc(1, sizeof(GUI_TextCacheEntry));
+	if(entry == NULL) {
+		SDL_FreeSurface(surface);
+		return NULL;
+	}
+
+	entry->texture = SDL_CreateTextureFromSurface(context->render, surface);
+	GUI_STAT_ADD(context, texturesCreated, entry->texture != NULL);
+	entry->bytes = (size_t) surface->w * surface->h * 4;
+	SDL_FreeSurface(surface);
+
+	entry->str = (char*) malloc(strlen(str) + 1);
+	if(entry->texture == NULL || entry->str == NULL) {
+		if(entry->texture != NULL) {
+			SDL_DestroyTexture(entry->texture);
+			GUI_STAT_ADD(context, texturesDestroyed, 1);
+		}
+		if(entry->str != NULL)
+			free(entry->str);
+		free(entry);
+		return NULL;
+	}
+
+	strcpy(entry->str, str);
+	entry->font = font;
+	entry->fg = fg;
+	entry->bg = bg;
+	entry->shaded = shaded;
+	entry->hash = hash;
+	entry->refCount = 1;
+	TTF_SizeText(GUI_InternalFont(context, font), str, &entry->width, &entry->height);
+
+	entry->hashNext = cache->buckets[hash & (cache->numBuckets - 1)];
+	cache->buckets[hash & (cache->numBuckets - 1)] = entry;
+	cache->numEntries++;
+	cache->bytes += entry->bytes;
+
+	GUI_InternalTextCacheTrim(context);
+	return entry;
+}
+
+// Images are shared through a cache keyed by their canonical path, so the same file opened through
+// different relative paths still maps to one texture. Scaling happens when drawing, so images of
+// any scale share the same entry. Entries are destroyed as soon as the last image using them is freed.
+static char* GUI_InternalCanonicalPath(const char *path) {
+#ifdef _WIN32
+	char *canonical = _fullpath(NULL, path, 0);
+#else
+	char *canonical = realpath(path, NULL);
+#endif
+	if(canonical != NULL)
+		return canonical;
+
+	canonical = (char*) malloc(strlen(path) + 1);
+	if(canonical != NULL)
+		strcpy(canonical, path);
+	return canonical;
+}
+static Uint32 GUI_InternalHashString(const char *str) {
+	Uint32 hash = 2166136261u;
+
+	for(const char *c = str; *c != 0; c++) {
+		hash = (hash ^ (Uint8) *c) * 16777619u;
+	}
+
+	return hash;
+}
+static GUI_ImageCacheEntry* GUI_InternalImageCacheFind(GUI_ImageCache *cache, const char *path) {
+	if(cache->numBuckets == 0)
+		return NULL;
+
+	Uint32 hash = GUI_InternalHashString(path);
+	GUI_ImageCacheEntry *entry = cache->buckets[hash & (cache->numBuckets - 1)];
+
+	while(entry != NULL && (entry->hash != hash || strcmp(entry->path, path) != 0)) {
+		entry = entry->hashNext;
+	}
+
+	return entry;
+}
+static bool GUI_InternalImageCacheGrow(GUI_ImageCache *cache) {
+	int numBuckets = cache->numBuckets == 0 ? 64 : cache->numBuckets * 2;
+	GUI_ImageCacheEntry **buckets = (GUI_ImageCacheEntry**) calloc(numBuckets, sizeof(GUI_ImageCacheEntry*));
+	if(buckets == NULL)
+		return true;
+
+	for(int i = 0; i < cache->numBuckets; i++) {
+		GUI_ImageCacheEntry *entry = cache->buckets[i];
+
+		while(entry != NULL) {
+			GUI_ImageCacheEntry *next = entry->hashNext;
+			entry->hashNext = buckets[entry->hash & (numBuckets - 1)];
+			buckets[entry->hash & (numBuckets - 1)] = entry;
+			entry = next;
+		}
+	}
+
+	if(cache->buckets != NULL)
+		free(cache->buckets);
+
+	cache->buckets = buckets;
+	cache->numBuckets = numBuckets;
+	return false;
+}
+static GUI_ImageCacheEntry* GUI_InternalImageCacheInsert(GUI_ImageCache *cache, const char *path, GUI_Image *image) {
+	if(cache->numEntries >= cache->numBuckets && GUI_InternalImageCacheGrow(cache))
+		return NULL;
+
+	GUI_ImageCacheEntry *entry = (GUI_ImageCacheEntry*) calloc(1, sizeof(GUI_ImageCacheEntry));
+	if(entry == NULL)
+		return NULL;
+
+	entry->path = (char*) malloc(strlen(path) + 1);
+	if(entry->path == NULL) {
+		free(entry);
+		return NULL;
+	}
+
+	strcpy(entry->path, path);
+	entry->hash = GUI_InternalHashString(path);
+	entry->texture = image->texture;
+	entry->src = image->src;
+	entry->page = image->page;
+	entry->refCount = 1;
+
+	entry->hashNext = cache->buckets[entry->hash & (cache->numBuckets - 1)];
+	cache->buckets[entry->hash & (cache->numBuckets - 1)] = entry;
+	cache->numEntries++;
+	return entry;
+}
+static void GUI_InternalImageCacheRelease(GUI_Context *context, GUI_ImageCacheEntry *entry) {
+	GUI_ImageCache *cache = &context->imageCache;
+
+	if(--entry->refCount > 0)
+		return;
+
+	GUI_ImageCacheEntry **link = &cache->buckets[entry->hash & (cache->numBuckets - 1)];
+	while(*link != entry) {
+		link = &(*link)->hashNext;
+	}
+	*link = entry->hashNext;
+
+	// textures in the image atlas belong to its pages
+	if(entry->page < 0)
+		GUI_InternalDestroyTexture(context, entry->texture);
+	else
+		GUI_InternalReleaseAtlasImage(context, entry->page);
+
+	cache->numEntries--;
+	free(entry->path);
+	free(entry);
+}
+
+// Listeners are stored in one small array per event type, so triggering an event only touches
+// the callbacks registered for it. Each component type uses its own range of buckets.
+static int GUI_InternalEventBucket(GUI_ComponentType componentType, GUI_EventType type) {
+	if(componentType == GUI_COMPONENT_BUTTON && type >= GUI_BUTTON_ON_PRESS && type <= GUI_BUTTON_ON_EXIT)
+		return type - GUI_BUTTON_ON_PRESS;
+	if(componentType == GUI_COMPONENT_SLIDER && type >= GUI_SLIDER_INTERNAL && type <= GUI_SLIDER_ON_RELEASE)
+		return type - GUI_SLIDER_INTERNAL;
+	// added after the image events, so it takes the bucket following the other slider events
+	if(componentType == GUI_COMPONENT_SLIDER && type == GUI_SLIDER_ON_CHANGE)
+		return GUI_SLIDER_ON_RELEASE - GUI_SLIDER_INTERNAL + 1;
+	if(componentType == GUI_COMPONENT_IMAGE && type >= GUI_IMAGE_ON_LOAD && type <= GUI_IMAGE_ON_FAIL)
+		return type - GUI_IMAGE_ON_LOAD;
+	if(componentType == GUI_COMPONENT_LIST_VIEW && type == GUI_LIST_VIEW_ON_SELECT)
+		return 0;
+
+	return -1;
+}
+static void GUI_InternalClearNodeEvents(GUI_ComponentNode *node) {
+	for(int i = 0; i < GUI_EVENT_BUCKETS; i++) {
+		GUI_EventList *list = &node->events[i];
+
+		if(list->events != list->inlineEvents)
+			free(list->events);
+
+		list->events = list->inlineEvents;
+		list->count = 0;
+		list->capacity = GUI_EVENT_INLINE_CAPACITY;
+	}
+}
+static void GUI_InternalTriggerNode(GUI_Context *context, GUI_ComponentNode *node, GUI_EventType type) {
+	int bucket = GUI_InternalEventBucket(node->type, type);
+	if(bucket < 0)
+		return;
+
+	GUI_EventList *list = &node->events[bucket];
+#ifdef GUI_ENABLE_STATS
+	// the slider's own handler isn't a user callback
+	Uint64 start = SDL_GetPerformanceCounter();
+	if(type != GUI_SLIDER_INTERNAL)
+		GUI_STAT_ADD(context, callbacks, list->count);
+#endif
+
+	for(int i = 0; i < list->count; i++) {
+		list->events[i](node->component);
+	}
+
+#ifdef GUI_ENABLE_STATS
+	if(type != GUI_SLIDER_INTERNAL)
+		GUI_STAT_ADD(context, callbackTicks, SDL_GetPerformanceCounter() - start);
+#endif
+}
+
+static bool GUI_InternalIsBmp(const char *path) {
+	int len = 0;
+
+	while(path[len] != 0) {
+		len++;
+	}
+
+	if(len < 4)
+		return false;
+
+	for(int i = 0; i < 4; i++) {
+		if(path[len - 4 + i] != BMP_FILE_ENDING[i])
+			return false;
+	}
+
+	return true;
+}
+static SDL_Surface* GUI_InternalLoadSurface(const char *path) {
+	if(GUI_InternalIsBmp(path))
+		return SDL_LoadBMP(path);
+	return IMG_Load(path);
+}
+static bool GUI_InternalUploadImage(GUI_Context *context, GUI_Image *image, SDL_Surface *surface, float xScale, float yScale) {
+	image->page = -1;
+	image->src = (SDL_Rect) {0, 0, surface->w, surface->h};
+
+	// images too big for a page, or that couldn't be packed, get a texture of their own
+	if(context->imageAtlas)
+		image->page = GUI_InternalAtlasAdd(context, &context->imagePages, &context->numImagePages, surface, &image->src);
+
+	if(image->page >= 0) {
+		image->texture = context->imagePages[image->page].texture;
+		context->imagePages[image->page].numImages++;
+	}
+	else {
+		image->src = (SDL_Rect) {0, 0, surface->w, surface->h};
+		image->texture = SDL_CreateTextureFromSurface(context->render, surface);
+		GUI_STAT_ADD(context, texturesCreated, image->texture != NULL);
+	}
+
+	if(image->texture == NULL)
+		return true;
+
+	image->width = image->src.w * xScale;
+	image->height = image->src.h * yScale;
+	return false;
+}
+
+// Gives an image the texture cached for `path`, or creates one from `surface` and caches it.
+static bool GUI_InternalResolveImage(GUI_Context *context, GUI_Image *image, const char *path, SDL_Surface *surface, float xScale, float yScale) {
+	GUI_ImageCacheEntry *entry = GUI_InternalImageCacheFind(&context->imageCache, path);
+
+	if(entry != NULL) {
+		context->imageCache.hits++;
+		entry->refCount++;
+
+		image->cacheEntry = entry;
+		image->texture = entry->texture;
+		image->src = entry->src;
+		image->page = entry->page;
+		image->width = image->src.w * xScale;
+		image->height = image->src.h * yScale;
+		return false;
+	}
+
+	context->imageCache.misses++;
+	if(surface == NULL || GUI_InternalUploadImage(context, image, surface, xScale, yScale))
+		return true;
+
+	// if the entry can't be created the image simply keeps its texture to itself
+	image->cacheEntry = GUI_InternalImageCacheInsert(&context->imageCache, path, image);
+	return false;
+}
+
+// Async images are decoded by a small pool of worker threads. Finished jobs are handed back to the
+// main thread, which creates the textures the next time GUI_Update is called, since the renderer
+// can only be used from the thread that created it.
+static int GUI_InternalLoaderThread(void *data) {
+	GUI_ImageLoader *loader = (GUI_ImageLoader*) data;
+
+	SDL_LockMutex(loader->lock);
+	while(true) {
+		while(loader->pending == NULL && !loader->quit) {
+			SDL_CondWait(loader->wake, loader->lock);
+		}
+		if(loader->quit)
+			break;
+
+		GUI_ImageJob *job = loader->pending;
+		loader->pending = job->next;
+		if(loader->pending == NULL)
+			loader->pendingTail = NULL;
+
+		// images freed before their turn are skipped
+		bool cancelled = job->image == NULL;
+		SDL_UnlockMutex(loader->lock);
+
+		if(!cancelled)
+			job->surface = GUI_InternalLoadSurface(job->path);
+
+		SDL_LockMutex(loader->lock);
+		job->next = loader->done;
+		loader->done = job;
+		SDL_UnlockMutex(loader->lock);
+
+		// wakes up the main thread's event loop so the image is uploaded promptly
+		if(loader->eventType != (Uint32) -1) {
+			SDL_Event event;
+			memset(&event, 0, sizeof(SDL_Event));
+			event.type = loader->eventType;
+			SDL_PushEvent(&event);
+		}
+
+		SDL_LockMutex(loader->lock);
+	}
+	SDL_UnlockMutex(loader->lock);
+
+	return 0;
+}
+static bool GUI_InternalStartLoader(GUI_Context *context) {
+	GUI_ImageLoader *loader = &context->loader;
+
+	loader->lock = SDL_CreateMutex();
+	loader->wake = SDL_CreateCond();
+	if(loader->lock == NULL || loader->wake == NULL) {
+		SDL_DestroyCond(loader->wake);
+		SDL_DestroyMutex(loader->lock);
+		loader->lock = NULL;
+		loader->wake = NULL;
+		return true;
+	}
+
+	loader->eventType = SDL_RegisterEvents(1);
+
+	int numThreads = SDL_GetCPUCount() - 1;
+	if(numThreads < 1)
+		numThreads = 1;
+	if(numThreads > GUI_LOADER_MAX_THREADS)
+		numThreads = GUI_LOADER_MAX_THREADS;
+
+	for(int i = 0; i < numThreads; i++) {
+		loader->threads[loader->numThreads] = SDL_CreateThread(GUI_InternalLoaderThread, "GUI_ImageLoader", loader);
+		if(loader->threads[loader->numThreads] != NULL)
+			loader->numThreads++;
+	}
+
+	return loader->numThreads == 0;
+}
+static void GUI_InternalFreeJob(GUI_ImageJob *job) {
+	if(job->surface != NULL)
+		SDL_FreeSurface(job->surface);
+	free(job->path);
+	free(job);
+}
+static void GUI_InternalStopLoader(GUI_Context *context) {
+	GUI_ImageLoader *loader = &context->loader;
+	if(loader->lock == NULL)
+		return;
+
+	SDL_LockMutex(loader->lock);
+	loader->quit = true;
+	SDL_CondBroadcast(loader->wake);
+	SDL_UnlockMutex(loader->lock);
+
+	for(int i = 0; i < loader->numThreads; i++) {
+		SDL_WaitThread(loader->threads[i], NULL);
+	}
+
+	GUI_ImageJob *lists[2] = {loader->pending, loader->done};
+	for(int i = 0; i < 2; i++) {
+		while(lists[i] != NULL) {
+			GUI_ImageJob *next = lists[i]->next;
+			if(lists[i]->image != NULL)
+				((GUI_Image*) lists[i]->image)->job = NULL;
+			GUI_InternalFreeJob(lists[i]);
+			lists[i] = next;
+		}
+	}
+
+	SDL_DestroyCond(loader->wake);
+	SDL_DestroyMutex(loader->lock);
+	memset(loader, 0, sizeof(GUI_ImageLoader));
+}
+static bool GUI_InternalDrainLoader(GUI_Context *context) {
+	GUI_ImageLoader *loader = &context->loader;
+
+	SDL_LockMutex(loader->lock);
+	GUI_ImageJob *job = loader->done;
+	loader->done = NULL;
+	SDL_UnlockMutex(loader->lock);
+
+	bool loaded = job != NULL;
+	while(job != NULL) {
+		GUI_ImageJob *next = job->next;
+		GUI_Image *image = (GUI_Image*) job->image;
+
+		if(image != NULL) {
+			image->job = NULL;
+
+			// images found in the cache already have their texture
+			bool failed = false;
+			if(image->texture == NULL)
+				failed = GUI_InternalResolveImage(context, image, job->path, job->surface, job->xScale, job->yScale);
+
+			GUI_ComponentNode *node = GUI_FindComponent(context, image);
+			if(node != NULL) {
+				GUI_InternalMarkNodeDirty(context, node);
+				GUI_InternalInvalidateLayout(context, node);
+				GUI_InternalTriggerNode(context, node, failed ? GUI_IMAGE_ON_FAIL : GUI_IMAGE_ON_LOAD);
+			}
+		}
+
+		GUI_InternalFreeJob(job);
+		job = next;
+	}
+
+	return loaded;
+}
+
+// Asset packs are built by guipack and mapped into memory once. Fonts and images are read straight
+// from the mapping, so only the pages that are actually used get loaded from disk.
+static Uint32 GUI_InternalRead32(const Uint8 *bytes) {
+	return (Uint32) bytes[0] | ((Uint32) bytes[1] << 8) | ((Uint32) bytes[2] << 16) | ((Uint32) bytes[3] << 24);
+}
+static void GUI_InternalUnmapPack(GUI_Pack *pack) {
+#ifdef _WIN32
+	if(pack->data != NULL)
+		UnmapViewOfFile(pack->data);
+	if(pack->mapping != NULL)
+		CloseHandle(pack->mapping);
+	if(pack->file != NULL)
+		CloseHandle(pack->file);
+#else
+	if(pack->data != NULL)
+		munmap((void*) pack->data, pack->size);
+#endif
+	if(pack->path != NULL)
+		free(pack->path);
+	memset(pack, 0, sizeof(GUI_Pack));
+}
+static bool GUI_InternalMapFile(GUI_Pack *pack, const char *path) {
+	memset(pack, 0, sizeof(GUI_Pack));
+
+#ifdef _WIN32
+	LARGE_INTEGER size;
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(file == INVALID_HANDLE_VALUE)
+		return true;
+
+	pack->file = file;
+	if(!GetFileSizeEx(file, &size) || size.QuadPart < 12)
+		return true;
+	pack->size = (size_t) size.QuadPart;
+
+	pack->mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if(pack->mapping == NULL)
+		return true;
+
+	pack->data = (const Uint8*) MapViewOfFile(pack->mapping, FILE_MAP_READ, 0, 0, 0);
+	if(pack->data == NULL)
+		return true;
+#else
+	struct stat info;
+	int file = open(path, O_RDONLY);
+	if(file < 0)
+		return true;
+
+	if(fstat(file, &info) != 0 || info.st_size < 12) {
+		close(file);
+		return true;
+	}
+
+	// the mapping stays valid after the file is closed
+	void *data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if(data == MAP_FAILED)
+		return true;
+
+	pack->data = (const Uint8*) data;
+	pack->size = info.st_size;
+#endif
+
+	return false;
+}
+static bool GUI_InternalMapPack(GUI_Pack *pack, const char *path) {
+	if(GUI_InternalMapFile(pack, path))
+		return true;
+
+	pack->count = GUI_InternalRead32(pack->data + 8);
+	if(memcmp(pack->data, "GPAK", 4) != 0 || GUI_InternalRead32(pack->data + 4) != GUI_PACK_VERSION || pack->count > (pack->size - 12) / 16)
+		return true;
+
+	pack->path = GUI_InternalCanonicalPath(path);
+	return pack->path == NULL;
+}
+static SDL_RWops* GUI_InternalOpenPackEntry(GUI_Context *context, GUI_PackID id, const char *name) {
+	if(id < 0 || id >= context->numPacks)
+		return NULL;
+
+	GUI_Pack *pack = &context->packs[id];
+	size_t nameLength = strlen(name);
+	Uint32 low = 0, high = pack->count;
+
+	while(low < high) {
+		Uint32 mid = low + (high - low) / 2;
+		const Uint8 *entry = pack->data + 12 + mid * 16;
+		Uint32 entryNameOffset = GUI_InternalRead32(entry);
+		Uint32 entryNameLength = GUI_InternalRead32(entry + 4);
+		Uint32 dataOffset = GUI_InternalRead32(entry + 8);
+		Uint32 dataSize = GUI_InternalRead32(entry + 12);
+
+		if((size_t) entryNameOffset + entryNameLength > pack->size)
+			return NULL;
+
+		int order = memcmp(pack->data + entryNameOffset, name, entryNameLength < nameLength ? entryNameLength : nameLength);
+		if(order == 0)
+			order = entryNameLength < nameLength ? -1 : entryNameLength > nameLength;
+
+		if(order < 0) {
+			low = mid + 1;
+		}
+		else if(order > 0) {
+			high = mid;
+		}
+		else {
+			if((size_t) dataOffset + dataSize > pack->size)
+				return NULL;
+			return SDL_RWFromConstMem(pack->data + dataOffset, dataSize);
+		}
+	}
+
+	return NULL;
+}
+// Other threads can't touch components directly, so they post commands to a lock-free queue that
+// is drained at the start of GUI_Update. The queue is an intrusive multi-producer, single-consumer
+// linked list: posting swaps the new command into the head, and only the GUI thread walks the tail.
+static void GUI_InternalQueuePush(GUI_CommandQueue *queue, GUI_Command *command) {
+	SDL_AtomicSetPtr((void**) &command->next, NULL);
+	GUI_Command *previous = (GUI_Command*) SDL_AtomicSetPtr((void**) &queue->head, command);
+	SDL_AtomicSetPtr((void**) &previous->next, command);
+}
+static GUI_Command* GUI_InternalQueuePop(GUI_CommandQueue *queue) {
+	GUI_Command *tail = queue->tail;
+	GUI_Command *next = (GUI_Command*) SDL_AtomicGetPtr((void**) &tail->next);
+
+	if(tail == &queue->stub) {
+		if(next == NULL)
+			return NULL;
+
+		queue->tail = next;
+		tail = next;
+		next = (GUI_Command*) SDL_AtomicGetPtr((void**) &tail->next);
+	}
+
+	if(next != NULL) {
+		queue->tail = next;
+		return tail;
+	}
+
+	// a producer has swapped in a command but not linked it yet, it'll be picked up next time
+	if(tail != (GUI_Command*) SDL_AtomicGetPtr((void**) &queue->head))
+		return NULL;
+
+	GUI_InternalQueuePush(queue, &queue->stub);
+	next = (GUI_Command*) SDL_AtomicGetPtr((void**) &tail->next);
+	if(next != NULL) {
+		queue->tail = next;
+		return tail;
+	}
+
+	return NULL;
+}
+static void GUI_InternalFreeCommand(GUI_Command *command) {
+	if(command->str != NULL)
+		free(command->str);
+	free(command);
+}
+static void GUI_InternalFreeComponentData(GUI_Context *context, GUI_ComponentNode *node) {
+	if(node->type == GUI_COMPONENT_TEXT)
+		GUI_FreeText(context, (GUI_Text*) node->component);
+	else if(node->type == GUI_COMPONENT_IMAGE)
+		GUI_FreeImage(context, (GUI_Image*) node->component);
+	else if(node->type == GUI_COMPONENT_BUTTON)
+		GUI_FreeButton(context, (GUI_Button*) node->component);
+	else if(node->type == GUI_COMPONENT_SLIDER)
+		GUI_FreeSlider(context, (GUI_Slider*) node->component);
+	else if(node->type == GUI_COMPONENT_CONTAINER)
+		GUI_FreeContainer(context, (GUI_Container*) node->component);
+	else if(node->type == GUI_COMPONENT_LIST_VIEW)
+		GUI_FreeListView(context, (GUI_ListView*) node->component);
+}
+
+GUI_Context* GUI_Init(SDL_Window *win, SDL_Renderer *render) {
+	if(!SDL_WasInit(SDL_INIT_VIDEO | SDL_INIT_EVENTS))
+		return NULL;
+
+	if(TTF_Init() < 0) {
+		printf("%s\n", SDL_GetError());
+		return NULL;
+	}
+
+	if(IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG | IMG_INIT_WEBP | IMG_INIT_TIF) < 0) {
+		printf("%s\n", SDL_GetError());
+		return NULL;
+	}
+
+	GUI_Context *context = (GUI_Context*)malloc(sizeof(GUI_Context));
+
+	context->window = win;
+	context->render = render;
+	SDL_GetWindowSize(win, &context->width, &context->height);
+	context->components = NULL;
+	context->componentsTail = NULL;
+	GUI_PoolInit(&context->componentPool, sizeof(GUI_ComponentNode), GUI_POOL_ITEMS_PER_SLAB);
+	context->registry = NULL;
+	context->registryCapacity = 0;
+	context->registryCount = 0;
+	GUI_GridInit(&context->grid, context->width, context->height, GUI_GRID_CELL_SIZE);
+	context->hot = (GUI_HotStore) {NULL, NULL, NULL, NULL, NULL, NULL, NULL, 0, 0};
+	context->drawn = NULL;
+	context->active = NULL;
+	context->numDrawn = 0;
+	context->drawnCapacity = 0;
+	context->numActive = 0;
+	context->activeCapacity = 0;
+	context->updateCount = 0;
+	context->fonts = NULL;
+	context->atlases = NULL;
+	context->numFonts = 0;
+	memset(&context->textCache, 0, sizeof(GUI_TextCache));
+	context->textCache.budget = GUI_TEXT_CACHE_DEFAULT_BUDGET;
+	memset(&context->drawList, 0, sizeof(GUI_DrawList));
+	context->frame = NULL;
+	context->frameWidth = 0;
+	context->frameHeight = 0;
+	context->dirtyRect = (SDL_Rect) {0, 0, 0, 0};
+	context->dirty = true;
+	context->directDraw = false;
+	context->imagePages = NULL;
+	context->numImagePages = 0;
+	context->imageAtlas = false;
+	memset(&context->loader, 0, sizeof(GUI_ImageLoader));
+	memset(&context->imageCache, 0, sizeof(GUI_ImageCache));
+	context->packs = NULL;
+	context->numPacks = 0;
+	memset(&context->commands, 0, sizeof(GUI_CommandQueue));
+	context->commands.head = &context->commands.stub;
+	context->commands.tail = &context->commands.stub;
+	context->commands.eventType = SDL_RegisterEvents(1);
+	memset(&context->stats, 0, sizeof(GUI_FrameStats));
+	context->redraw = true;
+	context->animating = false;
+	context->root = NULL;
+	context->layoutRoots = NULL;
+	context->numLayoutRoots = 0;
+	context->layoutRootsCapacity = 0;
+	context->layoutDirty = false;
+	
+	return context;
+}
+void GUI_Quit(GUI_Context *context) {
+	GUI_InternalStopLoader(context);
+
+	GUI_Command *command;
+	while((command = GUI_InternalQueuePop(&context->commands)) != NULL) {
+		GUI_InternalFreeCommand(command);
+	}
+	if(context->commands.drained != NULL)
+		free(context->commands.drained);
+
+	for(GUI_ComponentNode *node = context->components; node != NULL; node = node->next) {
+		GUI_InternalClearNodeEvents(node);
+		GUI_InternalFreeComponentData(context, node);
+	}
+
+	GUI_PoolDestroy(&context->componentPool);
+	GUI_InternalTextCacheDestroy(context);
+	if(context->imageCache.buckets != NULL)
+		free(context->imageCache.buckets);
+	if(context->drawList.commands != NULL)
+		free(context->drawList.commands);
+	if(context->drawList.vertices != NULL)
+		free(context->drawList.vertices);
+	if(context->drawList.indices != NULL)
+		free(context->drawList.indices);
+	if(context->frame != NULL)
+		SDL_DestroyTexture(context->frame);
+	GUI_InternalDestroyPages(context->imagePages, context->numImagePages);
+
+	for(int i = 0; i < context->numFonts; i++) {
+		if(context->fonts[i] != NULL)
+			TTF_CloseFont(context->fonts[i]);
+		if(context->atlases[i].path != NULL)
+			free(context->atlases[i].path);
+		GUI_InternalDestroyPages(context->atlases[i].pages, context->atlases[i].numPages);
+	}
+	if(context->fonts != NULL)
+		free(context->fonts);
+	if(context->atlases != NULL)
+		free(context->atlases);
+
+	// fonts read from packs have to be closed before the packs are unmapped
+	for(int i = 0; i < context->numPacks; i++) {
+		GUI_InternalUnmapPack(&context->packs[i]);
+	}
+	if(context->packs != NULL)
+		free(context->packs);
+	if(context->registry != NULL)
+		free(context->registry);
+	GUI_GridDestroy(&context->grid);
+	GUI_HotDestroy(&context->hot);
+	if(context->drawn != NULL)
+		free(context->drawn);
+	if(context->active != NULL)
+		free(context->active);
+	if(context->layoutRoots != NULL)
+		free(context->layoutRoots);
+
+	TTF_Quit();
+	IMG_Quit();
+
+	free(context);
+}
+
+// The registry is an open addressing hash table (linear probing) mapping component pointers to their nodes,
+// so looking up a component never has to walk the component list.
+static size_t GUI_InternalHashPointer(void *component, int capacity) {
+	uintptr_t key = (uintptr_t) component;
+	key ^= key >> 4;
+	key *= (uintptr_t) 0x9e3779b97f4a7c15ull;
+	key ^= key >> 29;
+
+	return (size_t) key & (size_t) (capacity - 1);
+}
+static void GUI_InternalRegistryInsert(GUI_ComponentNode **registry, int capacity, GUI_ComponentNode *node) {
+	size_t i = GUI_InternalHashPointer(node->component, capacity);
+
+	while(registry[i] != NULL) {
+		i = (i + 1) & (size_t) (capacity - 1);
+	}
+
+	registry[i] = node;
+}
+static bool GUI_InternalRegistryGrow(GUI_Context *context) {
+	int capacity = context->registryCapacity == 0 ? GUI_REGISTRY_MIN_CAPACITY : context->registryCapacity * 2;
+	GUI_ComponentNode **registry = (GUI_ComponentNode**) calloc(capacity, sizeof(GUI_ComponentNode*));
+	if(registry == NULL)
+		return true;
+
+	for(int i = 0; i < context->registryCapacity; i++) {
+		if(context->registry[i] != NULL)
+			GUI_InternalRegistryInsert(registry, capacity, context->registry[i]);
+	}
+
+	if(context->registry != NULL)
+		free(context->registry);
+
+	context->registry = registry;
+	context->registryCapacity = capacity;
+	return false;
+}
+static void GUI_InternalRegistryRemove(GUI_Context *context, void *component) {
+	if(context->registryCapacity == 0)
+		return;
+
+	size_t mask = (size_t) (context->registryCapacity - 1);
+	size_t i = GUI_InternalHashPointer(component, context->registryCapacity);
+
+	while(context->registry[i] != NULL && context->registry[i]->component != component) {
+		i = (i + 1) & mask;
+	}
+
+	if(context->registry[i] == NULL)
+		return;
+
+	context->registry[i] = NULL;
+	context->registryCount--;
+
+	// shift the rest of the probe run back so lookups never stop early on the new hole
+	size_t j = (i + 1) & mask;
+	while(context->registry[j] != NULL) {
+		size_t home = GUI_InternalHashPointer(context->registry[j]->component, context->registryCapacity);
+
+		if(((j - home) & mask) >= ((j - i) & mask)) {
+			context->registry[i] = context->registry[j];
+			context->registry[j] = NULL;
+			i = j;
+		}
+
+		j = (j + 1) & mask;
+	}
+}
+GUI_ComponentNode* GUI_FindComponent(GUI_Context *context, void *component) {
+	if(context->registryCapacity == 0 || component == NULL)
+		return NULL;
+
+	size_t i = GUI_InternalHashPointer(component, context->registryCapacity);
+
+	while(context->registry[i] != NULL) {
+		if(context->registry[i]->component == component)
+			return context->registry[i];
+
+		i = (i + 1) & (size_t) (context->registryCapacity - 1);
+	}
+
+	return NULL;
+}
+
+bool GUI_SerializeComponent(GUI_Context *context, void *component, GUI_ComponentType type) {
+	bool interactive = type == GUI_COMPONENT_BUTTON || type == GUI_COMPONENT_SLIDER || type == GUI_COMPONENT_LIST_VIEW;
+
+	if((context->registryCount + 1) * 2 > context->registryCapacity && GUI_InternalRegistryGrow(context))
+		return true;
+	if(interactive && GUI_HotReserve(&context->hot, context->hot.count + 1))
+		return true;
+
+	GUI_ComponentNode *node = (GUI_ComponentNode*) GUI_PoolAlloc(&context->componentPool);
+	if(node == NULL)
+		return true;
+
+	node->component = component;
+	node->type = type;
+	for(int i = 0; i < GUI_EVENT_BUCKETS; i++) {
+		node->events[i].events = node->events[i].inlineEvents;
+		node->events[i].count = 0;
+		node->events[i].capacity = GUI_EVENT_INLINE_CAPACITY;
+	}
+	node->gridX0 = -1;
+	node->activeIndex = -1;
+	node->hotIndex = -1;
+	if(interactive)
+		GUI_HotAdd(&context->hot, node);
+	node->x = 0;
+	node->y = 0;
+	node->bounds = (SDL_Rect) {0, 0, 0, 0};
+	node->placed = false;
+	node->hidden = false;
+	node->commandDrain = 0;
+	node->commandMask = 0;
+	node->numOwners = 0;
+	node->owner = NULL;
+	node->parent = NULL;
+	node->prev = context->componentsTail;
+	node->next = NULL;
+
+	if(context->componentsTail != NULL)
+		context->componentsTail->next = node;
+	else
+		context->components = node;
+	context->componentsTail = node;
+
+	GUI_InternalRegistryInsert(context->registry, context->registryCapacity, node);
+	context->registryCount++;
+	return false;
+}
+void GUI_FreeComponent(GUI_Context *context, void *component) {
+	GUI_ComponentNode *node = GUI_FindComponent(context, component);
+
+	if(node == NULL)
+		return;
+
+	if(node->placed)
+		GUI_Unplace(context, component);
+
+	// children of a freed container are kept, they just no longer belong to it
+	if(node->parent != NULL)
+		GUI_RemoveChild(context, (GUI_Container*) node->parent->component, component);
+	if(node->type == GUI_COMPONENT_CONTAINER) {
+		GUI_Container *container = (GUI_Container*) component;
+
+		for(int i = 0; i < container->numChildren; i++) {
+			container->children[i].node->parent = NULL;
+		}
+		container->numChildren = 0;
+	}
+	if(context->root == node)
+		context->root = NULL;
+
+	if(node->type == GUI_COMPONENT_BUTTON) {
+		GUI_Button *button = (GUI_Button*) component;
+
+		if(button->textContent != NULL)
+			GUI_InternalSetOwner(context, button->textContent, button, false);
+		if(button->imageContent != NULL)
+			GUI_InternalSetOwner(context, button->imageContent, button, false);
+	}
+	else if(node->type == GUI_COMPONENT_SLIDER && ((GUI_Slider*) component)->inc != NULL) {
+		GUI_InternalSetOwner(context, ((GUI_Slider*) component)->inc, component, false);
+		GUI_InternalSetOwner(context, ((GUI_Slider*) component)->dec, component, false);
+	}
+
+	GUI_ClearEvents(context, component);
+	GUI_InternalRegistryRemove(context, component);
+	GUI_InternalForgetNode(context, node);
+	GUI_HotRemove(context, node);
+
+	if(node->prev == NULL)
+		context->components = node->next;
+	else
+		node->prev->next = node->next;
+
+	if(node->next == NULL)
+		context->componentsTail = node->prev;
+	else
+		node->next->prev = node->prev;
+
+	GUI_InternalFreeComponentData(context, node);
+	GUI_PoolFree(&context->componentPool, node);
+}
+GUI_PackID GUI_OpenPack(GUI_Context *context, const char *path) {
+	GUI_Pack *newPacks = (GUI_Pack*) realloc(context->packs, (context->numPacks + 1) * sizeof(GUI_Pack));
+	if(newPacks == NULL)
+		return -1;
+	context->packs = newPacks;
+
+	if(GUI_InternalMapPack(&context->packs[context->numPacks], path)) {
+		GUI_InternalUnmapPack(&context->packs[context->numPacks]);
+		return -1;
+	}
+
+	return context->numPacks++;
+}
+
+static GUI_FontID GUI_InternalAddFont(GUI_Context *context, TTF_Font *font) {
+	TTF_Font **newFonts = (TTF_Font**) calloc(context->numFonts + 1, sizeof(TTF_Font*));
+	GUI_GlyphAtlas *newAtlases = (GUI_GlyphAtlas*) calloc(context->numFonts + 1, sizeof(GUI_GlyphAtlas));
+	
+	for(int i = 0; i < context->numFonts; i++) {
+		newFonts[i] = context->fonts[i];
+		newAtlases[i] = context->atlases[i];
+	}
+
+	if(context->fonts != NULL)
+		free(context->fonts);
+	if(context->atlases != NULL)
+		free(context->atlases);
+
+	context->fonts = newFonts;
+	context->atlases = newAtlases;
+	context->fonts[context->numFonts] = font;
+	if(font != NULL) {
+		context->atlases[context->numFonts].height = TTF_FontHeight(font);
+		context->atlases[context->numFonts].lineSkip = TTF_FontLineSkip(font);
+	}
+	context->numFonts++;
+
+	return context->numFonts - 1;
+}
+GUI_FontID GUI_NewFont(GUI_Context *context, const char *path, int ptsize) {
+	TTF_Font* font = TTF_OpenFont(path, ptsize);
+	if(font == NULL)
+		return -1;
+
+	return GUI_InternalAddFont(context, font);
+}
+GUI_FontID GUI_NewFontFromPack(GUI_Context *context, GUI_PackID pack, const char *name, int ptsize) {
+	SDL_RWops *rw = GUI_InternalOpenPackEntry(context, pack, name);
+	if(rw == NULL)
+		return -1;
+
+	// the font keeps reading from the mapping, which stays valid until GUI_Quit
+	TTF_Font* font = TTF_OpenFontRW(rw, 1, ptsize);
+	if(font == NULL)
+		return -1;
+
+	return GUI_InternalAddFont(context, font);
+}
+
+static GUI_Text* GUI_InternalNewText(GUI_Context *context, GUI_FontID font, const char *str, SDL_Color fg, SDL_Color bg, bool shaded) {
+	GUI_Text *text = (GUI_Text*) malloc(sizeof(GUI_Text));
+	if(text == NULL)
+		return NULL;
+
+	text->str = (char*) malloc(strlen(str) + 1);
+	text->cacheEntry = GUI_InternalTextCacheAcquire(context, font, str, fg, bg, shaded);
+	if(text->cacheEntry == NULL || text->str == NULL) {
+		if(text->cacheEntry != NULL)
+			GUI_InternalTextCacheRelease(context, text->cacheEntry);
+		if(text->str != NULL)
+			free(text->str);
+		free(text);
+		return NULL;
+	}
+
+	strcpy(text->str, str);
+	text->font = font;
+	text->fg = fg;
+	text->bg = bg;
+	text->shaded = shaded;
+	text->texture = text->cacheEntry->texture;
+	text->width = text->cacheEntry->width;
+	text->height = text->cacheEntry->height;
+	text->textureWidth = text->width;
+	text->textureHeight = text->height;
+
+	if(GUI_SerializeComponent(context, text, GUI_COMPONENT_TEXT)) {
+		GUI_FreeText(context, text);
+		return NULL;
+	}
+	return text;
+}
+
+GUI_Text* GUI_NewTextBg(GUI_Context *context, GUI_FontID font, const char *str, SDL_Color fg, SDL_Color bg) {
+	return GUI_InternalNewText(context, font, str, fg, bg, true);
+}
+GUI_Text* GUI_NewText(GUI_Context *context, GUI_FontID font, const char *str, SDL_Color fg) {
+	return GUI_InternalNewText(context, font, str, fg, COLOR_BLACK, false);
+}
+void GUI_FreeText(GUI_Context *context, GUI_Text *text) {
+	if(text->cacheEntry != NULL)
+		GUI_InternalTextCacheRelease(context, text->cacheEntry);
+	else if(text->texture != NULL)
+		GUI_InternalDestroyTexture(context, text->texture);
+
+	free(text->str);
+	free(text);
+}
+// Changed text is rendered into a streaming texture owned by the text component. The texture is made
+// larger than needed, so it only has to be recreated once a string no longer fits inside of it.
+bool GUI_SetText(GUI_Context *context, GUI_Text *text, const char *str) {
+	if(strcmp(text->str, str) == 0)
+		return false;
+
+	char *newStr = (char*) malloc(strlen(str) + 1);
+	if(newStr == NULL)
+		return true;
+	strcpy(newStr, str);
+
+	SDL_Surface *surface = NULL;
+	if(str[0] != 0) {
+		if(text->shaded)
+			surface = TTF_RenderText_Shaded_Wrapped(GUI_InternalFont(context, text->font), str, text->fg, text->bg, 0);
+		else
+			surface = TTF_RenderText_Blended_Wrapped(GUI_InternalFont(context, text->font), str, text->fg, 0);
+
+		if(surface == NULL) {
+			free(newStr);
+			return true;
+		}
+
+		if(surface->format->format != SDL_PIXELFORMAT_ARGB8888) {
+			SDL_Surface *converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+			SDL_FreeSurface(surface);
+			surface = converted;
+
+			if(surface == NULL) {
+				free(newStr);
+				return true;
+			}
+		}
+	}
+
+	if(surface != NULL && (text->cacheEntry != NULL || text->texture == NULL || surface->w > text->textureWidth || surface->h > text->textureHeight)) {
+		int textureWidth = surface->w + GUI_TEXT_HEADROOM;
+		int textureHeight = surface->h;
+		SDL_Texture *texture = SDL_CreateTexture(context->render, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, textureWidth, textureHeight);
+
+		if(texture == NULL) {
+			SDL_FreeSurface(surface);
+			free(newStr);
+			return true;
+		}
+		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+		GUI_STAT_ADD(context, texturesCreated, 1);
+
+		if(text->cacheEntry != NULL)
+			GUI_InternalTextCacheRelease(context, text->cacheEntry);
+		else if(text->texture != NULL)
+			GUI_InternalDestroyTexture(context, text->texture);
+
+		text->cacheEntry = NULL;
+		text->texture = texture;
+		text->textureWidth = textureWidth;
+		text->textureHeight = textureHeight;
+	}
+
+	int oldWidth = text->width, oldHeight = text->height;
+	if(surface != NULL) {
+		SDL_Rect rect = (SDL_Rect) {0, 0, surface->w, surface->h};
+		GUI_InternalFlushPending(context);
+		SDL_UpdateTexture(text->texture, &rect, surface->pixels, surface->pitch);
+		text->width = surface->w;
+		text->height = surface->h;
+		SDL_FreeSurface(surface);
+	}
+	else {
+		text->width = 0;
+	}
+
+	free(text->str);
+	text->str = newStr;
+
+	GUI_ComponentNode *node = GUI_FindComponent(context, text);
+	if(node != NULL) {
+		GUI_InternalMarkNodeDirty(context, node);
+		if(text->width != oldWidth || text->height != oldHeight)
+			GUI_InternalInvalidateLayout(context, node);
+	}
+	return false;
+}
+void GUI_SetTextCacheBudget(GUI_Context *context, size_t bytes) {
+	context->textCache.budget = bytes;
+	GUI_InternalTextCacheTrim(context);
+}
+void GUI_DrawText(GUI_Context *context, GUI_Text *text, int x, int y) {
+	if(text->width == 0 || GUI_InternalIsHidden(context, text))
+		return;
+
+	SDL_Rect rect = (SDL_Rect) {x, y, text->width, text->height};
+	SDL_Rect src = (SDL_Rect) {0, 0, text->width, text->height};
+	GUI_InternalPushTexture(context, text->texture, text->cacheEntry == NULL ? &src : NULL, text->textureWidth, text->textureHeight, &rect);
+	GUI_InternalEndDraw(context);
+}
+
+static GUI_Glyph* GUI_InternalGetGlyph(GUI_Context *context, GUI_FontID font, unsigned char c) {
+	GUI_GlyphAtlas *atlas = &context->atlases[font];
+	GUI_Glyph *glyph = &atlas->glyphs[c];
+
+	if(glyph->loaded)
+		return glyph;
+
+	glyph->loaded = true;
+	glyph->page = -1;
+	glyph->advance = 0;
+
+	TTF_Font *ttf = GUI_InternalFont(context, font);
+	if(ttf == NULL)
+		return glyph;
+	TTF_GlyphMetrics(ttf, c, NULL, NULL, NULL, NULL, &glyph->advance);
+
+	// glyphs are rasterized in white so a single atlas can be tinted to any color by the vertex colors
+	SDL_Surface *surface = TTF_RenderGlyph_Blended(ttf, c, COLOR_WHITE);
+	if(surface == NULL)
+		return glyph;
+
+	glyph->page = GUI_InternalAtlasAdd(context, &atlas->pages, &atlas->numPages, surface, &glyph->rect);
+	SDL_FreeSurface(surface);
+	return glyph;
+}
+void GUI_DrawString(GUI_Context *context, GUI_FontID font, const char *str, SDL_Color color, int x, int y) {
+	GUI_GlyphAtlas *atlas = &context->atlases[font];
+	int penX = x;
+
+	for(const unsigned char *c = (const unsigned char*) str; *c != 0; c++) {
+		if(*c == '\n') {
+			penX = x;
+			y += atlas->lineSkip;
+			continue;
+		}
+
+		GUI_Glyph *glyph = GUI_InternalGetGlyph(context, font, *c);
+		if(glyph->page >= 0) {
+			GUI_AtlasPage *page = &atlas->pages[glyph->page];
+			SDL_Rect dst = (SDL_Rect) {penX, y, glyph->rect.w, glyph->rect.h};
+			GUI_InternalPushQuad(context, page->texture, (float) glyph->rect.x / page->width, (float) glyph->rect.y / page->height, (float) (glyph->rect.x + glyph->rect.w) / page->width, (float) (glyph->rect.y + glyph->rect.h) / page->height, &dst, color);
+		}
+
+		penX += glyph->advance;
+	}
+
+	GUI_InternalEndDraw(context);
+}
+void GUI_SizeString(GUI_Context *context, GUI_FontID font, const char *str, int *width, int *height) {
+	GUI_GlyphAtlas *atlas = &context->atlases[font];
+	int lineWidth = 0, maxWidth = 0, lines = 1;
+
+	for(const unsigned char *c = (const unsigned char*) str; *c != 0; c++) {
+		if(*c == '\n') {
+			lineWidth = 0;
+			lines++;
+			continue;
+		}
+
+		lineWidth += GUI_InternalGetGlyph(context, font, *c)->advance;
+		if(lineWidth > maxWidth)
+			maxWidth = lineWidth;
+	}
+
+	if(width != NULL)
+		*width = maxWidth;
+	if(height != NULL)
+		*height = atlas->height + (lines - 1) * atlas->lineSkip;
+}
+
+// Baked fonts store the printable ASCII glyphs of a font at one size, already packed into atlas
+// pages as 8 bit coverage, so loading them only costs uploading the pages.
+//
+// Layout, all integers little endian:
+//   "GFNT", version, page size, height, line skip, number of pages
+//   per glyph: x, y, w, h, page, advance, loaded
+//   per page: shelf x, shelf y, shelf height, followed by page size * page size bytes of coverage
+#define GUI_BAKED_HEADER_SIZE 24
+#define GUI_BAKED_GLYPH_SIZE 28
+#define GUI_BAKED_PAGE_HEADER_SIZE 12
+
+static void GUI_InternalWrite32(FILE *file, Uint32 value) {
+	Uint8 bytes[4] = {value & 0xff, (value >> 8) & 0xff, (value >> 16) & 0xff, (value >> 24) & 0xff};
+	fwrite(bytes, 1, 4, file);
+}
+bool GUI_BakeFont(GUI_Context *context, GUI_FontID font, const char *path) {
+	TTF_Font *ttf = GUI_InternalFont(context, font);
+	if(ttf == NULL)
+		return true;
+
+	GUI_Glyph glyphs[GUI_ATLAS_GLYPHS];
+	GUI_AtlasPage *pages = NULL;
+	Uint8 **coverage = NULL;
+	int numPages = 0;
+	bool failed = false;
+
+	memset(glyphs, 0, sizeof(glyphs));
+	for(int c = GUI_BAKED_FIRST_GLYPH; c <= GUI_BAKED_LAST_GLYPH && !failed; c++) {
+		GUI_Glyph *glyph = &glyphs[c];
+		glyph->loaded = true;
+		glyph->page = -1;
+		TTF_GlyphMetrics(ttf, c, NULL, NULL, NULL, NULL, &glyph->advance);
+
+		SDL_Surface *surface = TTF_RenderGlyph_Blended(ttf, c, COLOR_WHITE);
+		if(surface == NULL)
+			continue;
+
+		SDL_Surface *converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+		SDL_FreeSurface(surface);
+		if(converted == NULL || converted->w > GUI_ATLAS_SIZE || converted->h > GUI_ATLAS_SIZE) {
+			if(converted != NULL)
+				SDL_FreeSurface(converted);
+			continue;
+		}
+
+		if(numPages == 0 || GUI_InternalAtlasPack(&pages[numPages - 1], converted->w, converted->h, &glyph->rect)) {
+			GUI_AtlasPage *newPages = (GUI_AtlasPage*) realloc(pages, (numPages + 1) * sizeof(GUI_AtlasPage));
+			if(newPages != NULL)
+				pages = newPages;
+
+			Uint8 **newCoverage = (Uint8**) realloc(coverage, (numPages + 1) * sizeof(Uint8*));
+			if(newCoverage != NULL)
+				coverage = newCoverage;
+
+			if(newPages == NULL || newCoverage == NULL || (coverage[numPages] = (Uint8*) calloc(GUI_ATLAS_SIZE * GUI_ATLAS_SIZE, 1)) == NULL) {
+				SDL_FreeSurface(converted);
+				failed = true;
+				break;
+			}
+
+			memset(&pages[numPages], 0, sizeof(GUI_AtlasPage));
+			pages[numPages].width = GUI_ATLAS_SIZE;
+			pages[numPages].height = GUI_ATLAS_SIZE;
+			GUI_InternalAtlasPack(&pages[numPages], converted->w, converted->h, &glyph->rect);
+			numPages++;
+		}
+
+		glyph->page = numPages - 1;
+		for(int y = 0; y < converted->h; y++) {
+			Uint32 *row = (Uint32*) ((Uint8*) converted->pixels + y * converted->pitch);
+			Uint8 *dst = coverage[glyph->page] + (glyph->rect.y + y) * GUI_ATLAS_SIZE + glyph->rect.x;
+
+			for(int x = 0; x < converted->w; x++) {
+				dst[x] = row[x] >> 24;
+			}
+		}
+		SDL_FreeSurface(converted);
+	}
+
+	FILE *file = failed ? NULL : fopen(path, "wb");
+	if(file != NULL) {
+		fwrite("GFNT", 1, 4, file);
+		GUI_InternalWrite32(file, GUI_BAKED_FONT_VERSION);
+		GUI_InternalWrite32(file, GUI_ATLAS_SIZE);
+		GUI_InternalWrite32(file, TTF_FontHeight(ttf));
+		GUI_InternalWrite32(file, TTF_FontLineSkip(ttf));
+		GUI_InternalWrite32(file, numPages);
+
+		for(int c = 0; c < GUI_ATLAS_GLYPHS; c++) {
+			GUI_InternalWrite32(file, glyphs[c].rect.x);
+			GUI_InternalWrite32(file, glyphs[c].rect.y);
+			GUI_InternalWrite32(file, glyphs[c].rect.w);
+			GUI_InternalWrite32(file, glyphs[c].rect.h);
+			GUI_InternalWrite32(file, glyphs[c].page);
+			GUI_InternalWrite32(file, glyphs[c].advance);
+			GUI_InternalWrite32(file, glyphs[c].loaded);
+		}
+		for(int i = 0; i < numPages; i++) {
+			GUI_InternalWrite32(file, pages[i].shelfX);
+			GUI_InternalWrite32(file, pages[i].shelfY);
+			GUI_InternalWrite32(file, pages[i].shelfHeight);
+			fwrite(coverage[i], 1, GUI_ATLAS_SIZE * GUI_ATLAS_SIZE, file);
+		}
+
+		failed = ferror(file) != 0;
+		fclose(file);
+	}
+	else {
+		failed = true;
+	}
+
+	for(int i = 0; i < numPages; i++) {
+		free(coverage[i]);
+	}
+	if(coverage != NULL)
+		free(coverage);
+	if(pages != NULL)
+		free(pages);
+
+	return failed;
+}
+static bool GUI_InternalLoadBakedPages(GUI_Context *context, GUI_GlyphAtlas *atlas, const GUI_Pack *file, int numPages) {
+	Uint32 *pixels = (Uint32*) malloc(GUI_ATLAS_SIZE * GUI_ATLAS_SIZE * sizeof(Uint32));
+	atlas->pages = (GUI_AtlasPage*) calloc(numPages, sizeof(GUI_AtlasPage));
+	if(pixels == NULL || atlas->pages == NULL) {
+		free(pixels);
+		return true;
+	}
+
+	const Uint8 *page = file->data + GUI_BAKED_HEADER_SIZE + GUI_ATLAS_GLYPHS * GUI_BAKED_GLYPH_SIZE;
+	for(int i = 0; i < numPages; i++) {
+		GUI_AtlasPage *atlasPage = &atlas->pages[i];
+		atlasPage->width = GUI_ATLAS_SIZE;
+		atlasPage->height = GUI_ATLAS_SIZE;
+		atlasPage->shelfX = GUI_InternalRead32(page);
+		atlasPage->shelfY = GUI_InternalRead32(page + 4);
+		atlasPage->shelfHeight = GUI_InternalRead32(page + 8);
+
+		const Uint8 *coverage = page + GUI_BAKED_PAGE_HEADER_SIZE;
+		for(int j = 0; j < GUI_ATLAS_SIZE * GUI_ATLAS_SIZE; j++) {
+			pixels[j] = ((Uint32) coverage[j] << 24) | 0xffffff;
+		}
+
+		atlasPage->texture = SDL_CreateTexture(context->render, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, GUI_ATLAS_SIZE, GUI_ATLAS_SIZE);
+		if(atlasPage->texture == NULL) {
+			free(pixels);
+			return true;
+		}
+		GUI_STAT_ADD(context, texturesCreated, 1);
+
+		SDL_SetTextureBlendMode(atlasPage->texture, SDL_BLENDMODE_BLEND);
+		SDL_UpdateTexture(atlasPage->texture, NULL, pixels, GUI_ATLAS_SIZE * sizeof(Uint32));
+		atlas->numPages++;
+		page += GUI_BAKED_PAGE_HEADER_SIZE + GUI_ATLAS_SIZE * GUI_ATLAS_SIZE;
+	}
+
+	free(pixels);
+	return false;
+}
+GUI_FontID GUI_NewBakedFont(GUI_Context *context, const char *bakedPath, const char *fontPath, int ptsize) {
+	GUI_Pack file;
+	if(GUI_InternalMapFile(&file, bakedPath)) {
+		GUI_InternalUnmapPack(&file);
+		return -1;
+	}
+
+	Uint32 numPages = 0;
+	if(file.size >= GUI_BAKED_HEADER_SIZE + GUI_ATLAS_GLYPHS * GUI_BAKED_GLYPH_SIZE)
+		numPages = GUI_InternalRead32(file.data + 20);
+
+	size_t pageSize = GUI_BAKED_PAGE_HEADER_SIZE + GUI_ATLAS_SIZE * GUI_ATLAS_SIZE;
+	if(memcmp(file.data, "GFNT", 4) != 0 || GUI_InternalRead32(file.data + 4) != GUI_BAKED_FONT_VERSION || GUI_InternalRead32(file.data + 8) != GUI_ATLAS_SIZE
+		|| file.size < GUI_BAKED_HEADER_SIZE + GUI_ATLAS_GLYPHS * GUI_BAKED_GLYPH_SIZE
+		|| numPages > (file.size - GUI_BAKED_HEADER_SIZE - GUI_ATLAS_GLYPHS * GUI_BAKED_GLYPH_SIZE) / pageSize) {
+		GUI_InternalUnmapPack(&file);
+		return -1;
+	}
+
+	char *path = (char*) malloc(strlen(fontPath) + 1);
+	if(path == NULL) {
+		GUI_InternalUnmapPack(&file);
+		return -1;
+	}
+	strcpy(path, fontPath);
+
+	GUI_FontID font = GUI_InternalAddFont(context, NULL);
+	GUI_GlyphAtlas *atlas = &context->atlases[font];
+	atlas->height = GUI_InternalRead32(file.data + 12);
+	atlas->lineSkip = GUI_InternalRead32(file.data + 16);
+	atlas->path = path;
+	atlas->ptsize = ptsize;
+
+	for(int c = 0; c < GUI_ATLAS_GLYPHS; c++) {
+		const Uint8 *record = file.data + GUI_BAKED_HEADER_SIZE + c * GUI_BAKED_GLYPH_SIZE;
+		GUI_Glyph *glyph = &atlas->glyphs[c];
+
+		glyph->rect = (SDL_Rect) {GUI_InternalRead32(record), GUI_InternalRead32(record + 4), GUI_InternalRead32(record + 8), GUI_InternalRead32(record + 12)};
+		glyph->page = (int) GUI_InternalRead32(record + 16);
+		glyph->advance = GUI_InternalRead32(record + 20);
+		glyph->loaded = GUI_InternalRead32(record + 24) != 0;
+
+		if(glyph->page >= (int) numPages)
+			glyph->loaded = false;
+	}
+
+	// glyphs on pages that couldn't be created are rasterized again when needed
+	if(GUI_InternalLoadBakedPages(context, atlas, &file, numPages)) {
+		for(int c = 0; c < GUI_ATLAS_GLYPHS; c++) {
+			if(atlas->glyphs[c].page >= atlas->numPages)
+				atlas->glyphs[c].loaded = false;
+		}
+	}
+
+	GUI_InternalUnmapPack(&file);
+	return font;
+}
+
+GUI_Image* GUI_NewImage(GUI_Context *context, const char *path, float xScale, float yScale) {
+	char *key = GUI_InternalCanonicalPath(path);
+	if(key == NULL)
+		return NULL;
+
+	SDL_Surface *surface = NULL;
+	if(GUI_InternalImageCacheFind(&context->imageCache, key) == NULL) {
+		surface = GUI_InternalLoadSurface(path);
+
+		if(surface == NULL) {
+			free(key);
+			return NULL;
+		}
+	}
+
+	GUI_Image* image = (GUI_Image*) malloc(sizeof(GUI_Image));
+	bool failed = image == NULL;
+	if(image != NULL) {
+		image->cacheEntry = NULL;
+		image->job = NULL;
+		failed = GUI_InternalResolveImage(context, image, key, surface, xScale, yScale);
+	}
+
+	if(surface != NULL)
+		SDL_FreeSurface(surface);
+	free(key);
+	if(failed) {
+		free(image);
+		return NULL;
+	}
+
+	if(GUI_SerializeComponent(context, image, GUI_COMPONENT_IMAGE)) {
+		GUI_FreeImage(context, image);
+		return NULL;
+	}
+	return image;
+}
+GUI_Image* GUI_NewImageFromPack(GUI_Context *context, GUI_PackID pack, const char *name, float xScale, float yScale) {
+	if(pack < 0 || pack >= context->numPacks)
+		return NULL;
+
+	// cached under the pack's path followed by the entry name
+	char *key = (char*) malloc(strlen(context->packs[pack].path) + strlen(name) + 2);
+	if(key == NULL)
+		return NULL;
+	sprintf(key, "%s:%s", context->packs[pack].path, name);
+
+	SDL_Surface *surface = NULL;
+	if(GUI_InternalImageCacheFind(&context->imageCache, key) == NULL) {
+		SDL_RWops *rw = GUI_InternalOpenPackEntry(context, pack, name);
+
+		if(rw != NULL && GUI_InternalIsBmp(name))
+			surface = SDL_LoadBMP_RW(rw, 1);
+		else if(rw != NULL)
+			surface = IMG_Load_RW(rw, 1);
+
+		if(surface == NULL) {
+			free(key);
+			return NULL;
+		}
+	}
+
+	GUI_Image* image = (GUI_Image*) malloc(sizeof(GUI_Image));
+	bool failed = image == NULL;
+	if(image != NULL) {
+		image->cacheEntry = NULL;
+		image->job = NULL;
+		failed = GUI_InternalResolveImage(context, image, key, surface, xScale, yScale);
+	}
+
+	if(surface != NULL)
+		SDL_FreeSurface(surface);
+	free(key);
+	if(failed) {
+		free(image);
+		return NULL;
+	}
+
+	if(GUI_SerializeComponent(context, image, GUI_COMPONENT_IMAGE)) {
+		GUI_FreeImage(context, image);
+		return NULL;
+	}
+	return image;
+}
+GUI_Image* GUI_NewImageAsync(GUI_Context *context, const char *path, float xScale, float yScale) {
+	if(context->loader.lock == NULL && GUI_InternalStartLoader(context)) {
+		GUI_InternalStopLoader(context);
+		return NULL;
+	}
+
+	GUI_Image *image = (GUI_Image*) malloc(sizeof(GUI_Image));
+	GUI_ImageJob *job = (GUI_ImageJob*) malloc(sizeof(GUI_ImageJob));
+	char *key = GUI_InternalCanonicalPath(path);
+	if(image == NULL || job == NULL || key == NULL) {
+		free(image);
+		free(job);
+		free(key);
+		return NULL;
+	}
+
+	job->path = key;
+	job->xScale = xScale;
+	job->yScale = yScale;
+	job->image = image;
+	job->surface = NULL;
+	job->next = NULL;
+
+	image->texture = NULL;
+	image->width = 0;
+	image->height = 0;
+	image->src = (SDL_Rect) {0, 0, 0, 0};
+	image->page = -1;
+	image->cacheEntry = NULL;
+	image->job = job;
+	if(GUI_SerializeComponent(context, image, GUI_COMPONENT_IMAGE)) {
+		free(image);
+		free(job);
+		free(key);
+		return NULL;
+	}
+
+	// cached images are ready right away, but still report through the loader so their events are called
+	bool cached = GUI_InternalImageCacheFind(&context->imageCache, key) != NULL;
+	if(cached)
+		GUI_InternalResolveImage(context, image, key, NULL, xScale, yScale);
+
+	SDL_LockMutex(context->loader.lock);
+	if(cached) {
+		job->next = context->loader.done;
+		context->loader.done = job;
+	}
+	else {
+		if(context->loader.pendingTail != NULL)
+			context->loader.pendingTail->next = job;
+		else
+			context->loader.pending = job;
+		context->loader.pendingTail = job;
+		SDL_CondSignal(context->loader.wake);
+	}
+	SDL_UnlockMutex(context->loader.lock);
+
+	if(cached && context->loader.eventType != (Uint32) -1) {
+		SDL_Event event;
+		memset(&event, 0, sizeof(SDL_Event));
+		event.type = context->loader.eventType;
+		SDL_PushEvent(&event);
+	}
+
+	return image;
+}
+void GUI_FreeImage(GUI_Context *context, GUI_Image *image) {
+	if(image->job != NULL) {
+		SDL_LockMutex(context->loader.lock);
+		image->job->image = NULL;
+		SDL_UnlockMutex(context->loader.lock);
+	}
+
+	if(image->cacheEntry != NULL)
+		GUI_InternalImageCacheRelease(context, image->cacheEntry);
+	else if(image->page >= 0)
+		GUI_InternalReleaseAtlasImage(context, image->page);
+	else if(image->texture != NULL)
+		GUI_InternalDestroyTexture(context, image->texture);
+	free(image);
+}
+void GUI_DrawImage(GUI_Context *context, GUI_Image *image, int x, int y) {
+	if(image->texture == NULL || GUI_InternalIsHidden(context, image))
+		return;
+
+	SDL_Rect rect = (SDL_Rect) {x, y, image->width, image->height};
+
+	if(image->page >= 0)
+		GUI_InternalPushTexture(context, image->texture, &image->src, context->imagePages[image->page].width, context->imagePages[image->page].height, &rect);
+	else
+		GUI_InternalPushTexture(context, image->texture, NULL, 0, 0, &rect);
+	GUI_InternalEndDraw(context);
+}
+void GUI_SetImageAtlas(GUI_Context *context, bool enabled) {
+	context->imageAtlas = enabled;
+}
+
+GUI_Button* GUI_NewButton(GUI_Context *context, int width, int height, int borderWidth, SDL_Color fillColor, SDL_Color borderColor, GUI_Text *textContent, GUI_Image *imageContent) {
+	GUI_Button *button = (GUI_Button*) malloc(sizeof(GUI_Button));
+
+	button->textContent = textContent;
+	button->imageContent = imageContent;
+	button->x = -1;
+	button->y = -1;
+	button->width = width;
+	button->height = height;
+	button->borderWidth = borderWidth;
+	button->fillColor = fillColor;
+	button->borderColor = borderColor;
+	button->inside = false;
+	button->pressed = false;
+
+	if(GUI_SerializeComponent(context, button, GUI_COMPONENT_BUTTON)) {
+		GUI_FreeButton(context, button);
+		return NULL;
+	}
+	if(textContent != NULL)
+		GUI_InternalSetOwner(context, textContent, button, true);
+	if(imageContent != NULL)
+		GUI_InternalSetOwner(context, imageContent, button, true);
+	return button;
+}
+void GUI_FreeButton(GUI_Context *context, GUI_Button *button) {
+	free(button);
+}
+void GUI_DrawButton(GUI_Context *context, GUI_Button *button, int x, int y) {
+	GUI_ComponentNode *node = GUI_FindComponent(context, button);
+	if(node != NULL && GUI_InternalNodeHidden(node))
+		return;
+
+	button->x = x;
+	button->y = y;
+	GUI_InternalMarkDrawn(context, node, x, y, x + button->width, y + button->height);
+
+	SDL_Rect rect = (SDL_Rect) {x, y, button->width, button->height};
+
+	GUI_InternalPushRect(context, &rect, button->fillColor);
+
+	if(button->borderWidth > 0) {
+		int border = button->borderWidth;
+		SDL_Rect edges[4] = {
+			{x, y, button->width, border},
+			{x, y + button->height - border, button->width, border},
+			{x, y + border, border, button->height - border * 2},
+			{x + button->width - border, y + border, border, button->height - border * 2}
+		};
+
+		for(int i = 0; i < 4; i++) {
+			GUI_InternalPushRect(context, &edges[i], button->borderColor);
+		}
+	}
+
+	int yPadding = 0;
+	int numContent = 1;
+
+	if(button->textContent != NULL) {
+		yPadding += button->textContent->height;
+		numContent++;
+	}
+	if(button->imageContent != NULL) {
+		yPadding += button->imageContent->height;
+		numContent++;
+	}
+
+	yPadding = (button->height - yPadding) / numContent;
+
+	if(button->imageContent != NULL) {
+		GUI_DrawImage(context, button->imageContent, x + (button->width - button->imageContent->width) / 2, y + yPadding);
+		y += yPadding + button->imageContent->height;
+	}
+	if(button->textContent != NULL) {
+		GUI_DrawText(context, button->textContent, x + (button->width - button->textContent->width) / 2, y + yPadding);
+	}
+
+	GUI_InternalEndDraw(context);
+}
+
+void GUI_InternalSliderEvent(void *component) {
+	GUI_Slider *slider = (GUI_Slider*)component;
+	int mouseX, mouseY;
+	SDL_GetMouseState(&mouseX, &mouseY);
+	
+	if(slider->vertical) {
+		slider->value = 1 - ((float)(mouseY - slider->y)) / slider->length;
+	}
+	else {
+		slider->value = ((float)(mouseX - slider->x)) / slider->length;
+	}
+
+	if(slider->value > 1.0)
+		slider->value = 1.0;
+	else if(slider->value < 0.0)
+		slider->value = 0.0;
+}
+
+GUI_Slider* GUI_NewSlider(GUI_Context *context, GUI_Button *incrementButton, GUI_Button *decrementButton, float buttonValueMod, int width, int length, bool vertical, SDL_Color sliderColor, SDL_Color handleColor) {
+	GUI_Slider *slider = (GUI_Slider*) malloc(sizeof(GUI_Slider));
+
+	if(incrementButton != NULL && decrementButton != NULL) {
+		slider->inc = incrementButton;
+		slider->dec = decrementButton;
+	}
+	else {
+		slider->inc = NULL;
+		slider->dec = NULL;
 	}
 	slider->x = -1;
 	slider->y = -1;
@@ -312,62 +2451,1201 @@ GUI_Slider* GUI_NewSlider(GUI_Context *context, GUI_Button *incrementButton, GUI
 	slider->value = 0.5;
 	slider->buttonValueMod = buttonValueMod;
 	slider->holding = false;
-	slider->onScreen = false;
+	slider->param = NULL;
+	slider->target = NULL;
+
+	if(GUI_SerializeComponent(context, slider, GUI_COMPONENT_SLIDER)) {
+		GUI_FreeSlider(context, slider);
+		return NULL;
+	}
+	GUI_AddEvent(context, slider, &GUI_InternalSliderEvent, GUI_SLIDER_INTERNAL);
+	if(slider->inc != NULL) {
+		GUI_InternalSetOwner(context, slider->inc, slider, true);
+		GUI_InternalSetOwner(context, slider->dec, slider, true);
+	}
+	return slider;
+}
+// sliders scrolling a list view or container are unlinked from both ends
+static void GUI_InternalUnlinkSlider(GUI_Slider *slider) {
+	if(slider->target == NULL)
+		return;
+
+	if(slider->target->type == GUI_COMPONENT_LIST_VIEW) {
+		((GUI_ListView*) slider->target->component)->slider = NULL;
+	}
+	else if(slider->target->type == GUI_COMPONENT_CONTAINER) {
+		GUI_Container *container = (GUI_Container*) slider->target->component;
+
+		if(container->hSlider == slider)
+			container->hSlider = NULL;
+		if(container->vSlider == slider)
+			container->vSlider = NULL;
+	}
+
+	slider->target = NULL;
+}
+void GUI_FreeSlider(GUI_Context *context, GUI_Slider *slider) {
+	GUI_InternalUnlinkSlider(slider);
+	free(slider);
+}
+// A published slider value can be read from any thread, like an audio callback, without locking.
+// The GUI thread is the only writer, and the value is stored as the bits of a float in one atomic
+// word, so readers always see either the old or the new value.
+static int GUI_InternalFloatBits(float value) {
+	union { float f; int i; } bits;
+	bits.f = value;
+	return bits.i;
+}
+static float GUI_InternalBitsFloat(int value) {
+	union { float f; int i; } bits;
+	bits.i = value;
+	return bits.f;
+}
+static void GUI_InternalSliderChanged(GUI_Context *context, GUI_ComponentNode *node) {
+	GUI_Slider *slider = (GUI_Slider*) node->component;
+
+	if(slider->param != NULL)
+		SDL_AtomicSet(&slider->param->value, GUI_InternalFloatBits(slider->value));
+
+	GUI_InternalMarkNodeDirty(context, node);
+	GUI_InternalTriggerNode(context, node, GUI_SLIDER_ON_CHANGE);
+
+	// a slider scrolling a list view or container moves it to the same fraction of the way down
+	float fraction = slider->vertical ? 1.0f - slider->value : slider->value;
+	if(slider->target != NULL && slider->target->type == GUI_COMPONENT_LIST_VIEW) {
+		GUI_ListView *list = (GUI_ListView*) slider->target->component;
+		int maxScroll = SDL_max(0, list->numRows * list->rowHeight - list->height);
+
+		GUI_InternalScrollListView(context, list, (int) (fraction * maxScroll + 0.5f), slider);
+	}
+	else if(slider->target != NULL && slider->target->type == GUI_COMPONENT_CONTAINER) {
+		GUI_Container *container = (GUI_Container*) slider->target->component;
+		int maxX = SDL_max(0, container->contentWidth - container->measuredWidth);
+		int maxY = SDL_max(0, container->contentHeight - container->measuredHeight);
+
+		if(slider->vertical)
+			GUI_InternalScrollContainer(context, container, container->scrollX, (int) (fraction * maxY + 0.5f), slider);
+		else
+			GUI_InternalScrollContainer(context, container, (int) (fraction * maxX + 0.5f), container->scrollY, slider);
+	}
+}
+void GUI_SetSliderValue(GUI_Context *context, GUI_Slider *slider, float value) {
+	if(value > 1.0)
+		value = 1.0;
+	else if(value < 0.0)
+		value = 0.0;
+
+	if(value == slider->value)
+		return;
+	slider->value = value;
+
+	GUI_ComponentNode *node = GUI_FindComponent(context, slider);
+	if(node != NULL)
+		GUI_InternalSliderChanged(context, node);
+	else if(slider->param != NULL)
+		SDL_AtomicSet(&slider->param->value, GUI_InternalFloatBits(slider->value));
+}
+void GUI_SetSliderParam(GUI_Slider *slider, GUI_SliderParam *param) {
+	slider->param = param;
+
+	if(param != NULL)
+		SDL_AtomicSet(&param->value, GUI_InternalFloatBits(slider->value));
+}
+void GUI_InitSliderParam(GUI_SliderParam *param, float value, int rampSamples) {
+	SDL_AtomicSet(&param->value, GUI_InternalFloatBits(value));
+	param->current = value;
+	param->target = value;
+	param->step = 0;
+	param->rampSamples = rampSamples;
+	param->remaining = 0;
+}
+float GUI_ReadSliderParam(GUI_SliderParam *param) {
+	return GUI_InternalBitsFloat(SDL_AtomicGet(&param->value));
+}
+float GUI_NextSliderSample(GUI_SliderParam *param) {
+	float target = GUI_ReadSliderParam(param);
+
+	// a new value starts a linear ramp from wherever the previous one got to
+	if(target != param->target) {
+		param->target = target;
+
+		if(param->rampSamples > 0) {
+			param->step = (target - param->current) / param->rampSamples;
+			param->remaining = param->rampSamples;
+		}
+		else {
+			param->current = target;
+			param->remaining = 0;
+		}
+	}
+
+	if(param->remaining > 0) {
+		param->current += param->step;
+		if(--param->remaining == 0)
+			param->current = param->target;
+	}
+
+	return param->current;
+}
+static void GUI_InternalSliderButtonPositions(GUI_Slider *slider, int x, int y, SDL_Point *inc, SDL_Point *dec) {
+	if(slider->vertical) {
+		*inc = (SDL_Point) {x - (slider->inc->width - slider->width) / 2, y - slider->inc->height - slider->width};
+		*dec = (SDL_Point) {x - (slider->inc->width - slider->width) / 2, y + slider->length + slider->width};
+	}
+	else {
+		*dec = (SDL_Point) {x - slider->dec->width - slider->width, y - (slider->dec->height - slider->width) / 2};
+		*inc = (SDL_Point) {x + slider->length + slider->width, y - (slider->inc->height - slider->width) / 2};
+	}
+}
+// the slider's bounds cover every possible handle position and both of its buttons
+static SDL_Rect GUI_InternalSliderBounds(GUI_Slider *slider, int x, int y) {
+	SDL_Rect bounds;
+
+	if(slider->vertical)
+		bounds = (SDL_Rect) {x - slider->width, y, slider->width * 3, slider->length};
+	else
+		bounds = (SDL_Rect) {x, y - slider->width, slider->length, slider->width * 3};
+
+	if(slider->inc != NULL) {
+		SDL_Point inc, dec;
+		GUI_InternalSliderButtonPositions(slider, x, y, &inc, &dec);
+
+		SDL_Rect incRect = (SDL_Rect) {inc.x, inc.y, slider->inc->width, slider->inc->height};
+		SDL_Rect decRect = (SDL_Rect) {dec.x, dec.y, slider->dec->width, slider->dec->height};
+		SDL_UnionRect(&bounds, &incRect, &bounds);
+		SDL_UnionRect(&bounds, &decRect, &bounds);
+	}
+
+	return bounds;
+}
+void GUI_DrawSlider(GUI_Context *context, GUI_Slider *slider, int x, int y) {
+	GUI_ComponentNode *node = GUI_FindComponent(context, slider);
+	if(node != NULL && GUI_InternalNodeHidden(node))
+		return;
+
+	slider->x = x;
+	slider->y = y;
+
+	SDL_Rect rect;
+	rect.x = x;
+	rect.y = y;
+
+	if(slider->vertical) {
+		rect.w = slider->width;
+		rect.h = slider->length;
+	}
+	else {
+		rect.w = slider->length;
+		rect.h = slider->width;
+	}
+
+	GUI_InternalPushRect(context, &rect, slider->sliderColor);
+
+	if(slider->vertical) {
+		rect.x = x - slider->width;
+		rect.y = y + slider->length - slider->width - (slider->length - slider->width) * slider->value;
+		rect.w = slider->width * 3;
+		rect.h = slider->width;
+	}
+	else {
+		rect.x = x + (slider->length - slider->width) * slider->value;
+		rect.y = y - slider->width;
+		rect.w = slider->width;
+		rect.h = slider->width * 3;
+	}
+
+	GUI_InternalPushRect(context, &rect, slider->handleColor);
+
+	if(slider->inc != NULL) {
+		SDL_Point inc, dec;
+		GUI_InternalSliderButtonPositions(slider, x, y, &inc, &dec);
+
+		if(slider->vertical) {
+			GUI_DrawButton(context, slider->inc, inc.x, inc.y);
+			GUI_DrawButton(context, slider->dec, dec.x, dec.y);
+		}
+		else {
+			GUI_DrawButton(context, slider->dec, dec.x, dec.y);
+			GUI_DrawButton(context, slider->inc, inc.x, inc.y);
+		}
+	}
+
+	SDL_Rect bounds = GUI_InternalSliderBounds(slider, x, y);
+	GUI_InternalMarkDrawn(context, node, bounds.x, bounds.y, bounds.x + bounds.w, bounds.y + bounds.h);
+	GUI_InternalEndDraw(context);
+}
+
+// List views only keep a text for each row that fits in the view, plus one for a row cut off at each
+// end. Row n always uses text n modulo the pool size, so scrolling by a row only renders the row that
+// came into view, and neither memory nor drawing depends on how many rows the list has.
+static GUI_Text* GUI_InternalNewRowText(GUI_FontID font, SDL_Color fg) {
+	GUI_Text *text = (GUI_Text*) calloc(1, sizeof(GUI_Text));
+	if(text == NULL)
+		return NULL;
+
+	text->str = (char*) calloc(1, 1);
+	if(text->str == NULL) {
+		free(text);
+		return NULL;
+	}
+
+	text->font = font;
+	text->fg = fg;
+	text->bg = COLOR_BLACK;
+	return text;
+}
+GUI_ListView* GUI_NewListView(GUI_Context *context, GUI_ListViewSource source, void *data, int numRows, int rowHeight, int width, int height, GUI_FontID font, SDL_Color fg, SDL_Color fillColor, SDL_Color selectedColor, GUI_Slider *slider) {
+	GUI_ListView *list = (GUI_ListView*) calloc(1, sizeof(GUI_ListView));
+	if(list == NULL)
+		return NULL;
+
+	list->source = source;
+	list->data = data;
+	list->numRows = numRows;
+	list->rowHeight = rowHeight > 0 ? rowHeight : 1;
+	list->x = -1;
+	list->y = -1;
+	list->width = width;
+	list->height = height;
+	list->font = font;
+	list->fg = fg;
+	list->fillColor = fillColor;
+	list->selectedColor = selectedColor;
+	list->selected = -1;
+
+	list->numPooled = height / list->rowHeight + 2;
+	list->rows = (GUI_Text**) calloc(list->numPooled, sizeof(GUI_Text*));
+	list->rowIndices = (int*) malloc(list->numPooled * sizeof(int));
+	for(int i = 0; list->rows != NULL && list->rowIndices != NULL && i < list->numPooled; i++) {
+		list->rows[i] = GUI_InternalNewRowText(font, fg);
+		list->rowIndices[i] = -1;
+	}
+
+	for(int i = 0; i < list->numPooled; i++) {
+		if(list->rows == NULL || list->rowIndices == NULL || list->rows[i] == NULL) {
+			GUI_FreeListView(context, list);
+			return NULL;
+		}
+	}
+
+	if(GUI_SerializeComponent(context, list, GUI_COMPONENT_LIST_VIEW)) {
+		GUI_FreeListView(context, list);
+		return NULL;
+	}
+
+	if(slider != NULL) {
+		GUI_InternalUnlinkSlider(slider);
+		GUI_SetSliderValue(context, slider, slider->vertical ? 1.0f : 0.0f);
+		slider->target = GUI_FindComponent(context, list);
+		list->slider = slider;
+	}
+
+	return list;
+}
+void GUI_FreeListView(GUI_Context *context, GUI_ListView *list) {
+	if(list->slider != NULL)
+		list->slider->target = NULL;
+
+	for(int i = 0; list->rows != NULL && i < list->numPooled; i++) {
+		if(list->rows[i] != NULL)
+			GUI_FreeText(context, list->rows[i]);
+	}
+
+	if(list->rows != NULL)
+		free(list->rows);
+	if(list->rowIndices != NULL)
+		free(list->rowIndices);
+	free(list);
+}
+// rows are asked for again the next time they're drawn
+void GUI_SetListViewRows(GUI_Context *context, GUI_ListView *list, int numRows) {
+	list->numRows = numRows;
+	if(list->selected >= numRows)
+		list->selected = -1;
+
+	for(int i = 0; i < list->numPooled; i++) {
+		list->rowIndices[i] = -1;
+	}
+
+	GUI_ComponentNode *node = GUI_FindComponent(context, list);
+	if(node != NULL)
+		GUI_InternalMarkNodeDirty(context, node);
+
+	// keeps the scroll position inside the new length, and the slider in the same place
+	int scroll = list->scroll;
+	list->scroll = -1;
+	GUI_ScrollListView(context, list, scroll);
+}
+// a scroll that came from a linked slider isn't sent back to it, since the slider already has its value
+static void GUI_InternalScrollListView(GUI_Context *context, GUI_ListView *list, int scroll, GUI_Slider *source) {
+	int maxScroll = SDL_max(0, list->numRows * list->rowHeight - list->height);
+
+	scroll = SDL_min(SDL_max(scroll, 0), maxScroll);
+	if(scroll == list->scroll)
+		return;
+	list->scroll = scroll;
+
+	GUI_ComponentNode *node = GUI_FindComponent(context, list);
+	if(node != NULL)
+		GUI_InternalMarkNodeDirty(context, node);
+
+	if(list->slider != NULL && list->slider != source) {
+		float fraction = maxScroll > 0 ? (float) scroll / maxScroll : 0.0f;
+		GUI_SetSliderValue(context, list->slider, list->slider->vertical ? 1.0f - fraction : fraction);
+	}
+}
+void GUI_ScrollListView(GUI_Context *context, GUI_ListView *list, int scroll) {
+	GUI_InternalScrollListView(context, list, scroll, NULL);
+}
+static GUI_Text* GUI_InternalListViewRow(GUI_Context *context, GUI_ListView *list, int row) {
+	int slot = row % list->numPooled;
+	GUI_Text *text = list->rows[slot];
+
+	if(list->rowIndices[slot] != row) {
+		const char *str = list->source != NULL ? list->source(row, list->data) : NULL;
+
+		// a row that can't be rendered is left empty instead of being tried again every frame
+		if(GUI_SetText(context, text, str != NULL ? str : ""))
+			GUI_SetText(context, text, "");
+		list->rowIndices[slot] = row;
+	}
+
+	return text;
+}
+void GUI_DrawListView(GUI_Context *context, GUI_ListView *list, int x, int y) {
+	GUI_ComponentNode *node = GUI_FindComponent(context, list);
+	if(node != NULL && GUI_InternalNodeHidden(node))
+		return;
+
+	list->x = x;
+	list->y = y;
+	GUI_InternalMarkDrawn(context, node, x, y, x + list->width, y + list->height);
+
+	SDL_Rect view = (SDL_Rect) {x, y, list->width, list->height};
+	GUI_InternalPushRect(context, &view, list->fillColor);
+
+	int first = list->scroll / list->rowHeight;
+	int last = SDL_min(list->numRows - 1, (list->scroll + list->height - 1) / list->rowHeight);
+
+	for(int row = first; row <= last; row++) {
+		int rowY = y + row * list->rowHeight - list->scroll;
+		SDL_Rect rect = (SDL_Rect) {x, rowY, list->width, list->rowHeight};
+		SDL_Rect clipped;
+
+		if(row == list->selected && SDL_IntersectRect(&rect, &view, &clipped))
+			GUI_InternalPushRect(context, &clipped, list->selectedColor);
+
+		// rows cut off by the edges of the view only draw the part of their text inside of it
+		GUI_Text *text = GUI_InternalListViewRow(context, list, row);
+		rect = (SDL_Rect) {x + GUI_LIST_VIEW_PADDING, rowY + (list->rowHeight - text->height) / 2, text->width, text->height};
+		if(text->width > 0 && SDL_IntersectRect(&rect, &view, &clipped)) {
+			SDL_Rect src = (SDL_Rect) {clipped.x - rect.x, clipped.y - rect.y, clipped.w, clipped.h};
+			GUI_InternalPushTexture(context, text->texture, &src, text->textureWidth, text->textureHeight, &clipped);
+		}
+	}
+
+	GUI_InternalEndDraw(context);
+}
+
+// Retained mode: placed components are drawn by GUI_Render into a cached frame texture, which is only
+// redrawn where something changed. Placed components receive input whether or not the frame was redrawn.
+static SDL_Rect GUI_InternalNodeBounds(GUI_ComponentNode *node) {
+	switch(node->type) {
+		case GUI_COMPONENT_TEXT:
+			return (SDL_Rect) {node->x, node->y, ((GUI_Text*) node->component)->width, ((GUI_Text*) node->component)->height};
+		case GUI_COMPONENT_IMAGE:
+			return (SDL_Rect) {node->x, node->y, ((GUI_Image*) node->component)->width, ((GUI_Image*) node->component)->height};
+		case GUI_COMPONENT_BUTTON:
+			return (SDL_Rect) {node->x, node->y, ((GUI_Button*) node->component)->width, ((GUI_Button*) node->component)->height};
+		case GUI_COMPONENT_SLIDER:
+			return GUI_InternalSliderBounds((GUI_Slider*) node->component, node->x, node->y);
+		case GUI_COMPONENT_CONTAINER:
+			return (SDL_Rect) {node->x, node->y, ((GUI_Container*) node->component)->rect.w, ((GUI_Container*) node->component)->rect.h};
+		case GUI_COMPONENT_LIST_VIEW:
+			return (SDL_Rect) {node->x, node->y, ((GUI_ListView*) node->component)->width, ((GUI_ListView*) node->component)->height};
+	}
+
+	return (SDL_Rect) {node->x, node->y, 0, 0};
+}
+// the area left by all the clipping containers a node is in, or false if none of them clip
+static bool GUI_InternalNodeClip(GUI_ComponentNode *node, SDL_Rect *clip) {
+	bool clipped = false;
+
+	for(GUI_ComponentNode *parent = node->parent; parent != NULL; parent = parent->parent) {
+		GUI_Container *container = (GUI_Container*) parent->component;
+		if(!container->clip)
+			continue;
+
+		SDL_Rect area = *clip;
+		if(!clipped)
+			*clip = container->rect;
+		else if(!SDL_IntersectRect(&area, &container->rect, clip))
+			*clip = (SDL_Rect) {0, 0, 0, 0};
+		clipped = true;
+	}
+
+	return clipped;
+}
+static SDL_Rect GUI_InternalVisibleBounds(GUI_ComponentNode *node) {
+	SDL_Rect bounds = GUI_InternalNodeBounds(node), clip, visible;
+
+	if(node->parent == NULL || !GUI_InternalNodeClip(node, &clip))
+		return bounds;
+	if(!SDL_IntersectRect(&bounds, &clip, &visible))
+		return (SDL_Rect) {bounds.x, bounds.y, 0, 0};
+
+	return visible;
+}
+static void GUI_InternalDrawNode(GUI_Context *context, GUI_ComponentNode *node) {
+	switch(node->type) {
+		case GUI_COMPONENT_TEXT:
+			GUI_DrawText(context, (GUI_Text*) node->component, node->x, node->y);
+			break;
+		case GUI_COMPONENT_IMAGE:
+			GUI_DrawImage(context, (GUI_Image*) node->component, node->x, node->y);
+			break;
+		case GUI_COMPONENT_BUTTON:
+			GUI_DrawButton(context, (GUI_Button*) node->component, node->x, node->y);
+			break;
+		case GUI_COMPONENT_SLIDER:
+			GUI_DrawSlider(context, (GUI_Slider*) node->component, node->x, node->y);
+			break;
+		case GUI_COMPONENT_CONTAINER:
+			// the children of a placed container are placed themselves
+			break;
+		case GUI_COMPONENT_LIST_VIEW:
+			GUI_DrawListView(context, (GUI_ListView*) node->component, node->x, node->y);
+			break;
+	}
+}
+// Nodes completely outside their clipping containers never reach the renderer. Nodes partly outside are
+// drawn with the clip rectangle narrowed to what's visible, which has to flush the batch around them.
+static void GUI_InternalDrawVisible(GUI_Context *context, GUI_ComponentNode *node, SDL_Rect *area) {
+	SDL_Rect bounds = GUI_InternalNodeBounds(node), clip, visible;
+
+	if(node->parent == NULL || !GUI_InternalNodeClip(node, &clip)) {
+		GUI_InternalDrawNode(context, node);
+		return;
+	}
+
+	if(!SDL_IntersectRect(&bounds, &clip, &visible))
+		return;
+	if(visible.w == bounds.w && visible.h == bounds.h) {
+		GUI_InternalDrawNode(context, node);
+		return;
+	}
+
+	if(area != NULL && !SDL_IntersectRect(&clip, area, &visible))
+		return;
+	else if(area == NULL)
+		visible = clip;
+
+	GUI_Flush(context);
+	SDL_RenderSetClipRect(context->render, &visible);
+	GUI_STAT_ADD(context, renderCalls, 1);
+	GUI_InternalDrawNode(context, node);
+	GUI_Flush(context);
+	SDL_RenderSetClipRect(context->render, area);
+	GUI_STAT_ADD(context, renderCalls, 1);
+}
+static void GUI_InternalMarkNodeDirty(GUI_Context *context, GUI_ComponentNode *node) {
+	context->redraw = true;
+
+	// parts of other components (button content, slider buttons) are drawn wherever their owner is, and
+	// components that were never placed aren't in the cached frame at all
+	if(!node->placed) {
+		if(node->numOwners == 1 && node->owner != NULL)
+			GUI_InternalMarkNodeDirty(context, node->owner);
+		else if(node->numOwners > 0) {
+			context->dirty = true;
+			context->dirtyRect = (SDL_Rect) {0, 0, context->frameWidth, context->frameHeight};
+		}
+
+		return;
+	}
+
+	SDL_Rect bounds = GUI_InternalVisibleBounds(node);
+	SDL_UnionRect(&context->dirtyRect, &node->bounds, &context->dirtyRect);
+	SDL_UnionRect(&context->dirtyRect, &bounds, &context->dirtyRect);
+	context->dirty = true;
+}
+// a part shared by several components can't be traced back to one of them, and dirties the whole frame
+static void GUI_InternalSetOwner(GUI_Context *context, void *part, void *owner, bool owned) {
+	GUI_ComponentNode *partNode = GUI_FindComponent(context, part);
+	GUI_ComponentNode *ownerNode = GUI_FindComponent(context, owner);
+
+	if(partNode == NULL || ownerNode == NULL)
+		return;
+
+	if(owned) {
+		partNode->numOwners++;
+		partNode->owner = ownerNode;
+	}
+	else {
+		partNode->numOwners--;
+		if(partNode->owner == ownerNode)
+			partNode->owner = NULL;
+	}
+}
+static void GUI_InternalSetRetained(GUI_Context *context, GUI_ComponentNode *node, bool retained) {
+	GUI_HotSetFlag(&context->hot, node, GUI_HOT_RETAINED, retained);
+
+	if(node->type == GUI_COMPONENT_SLIDER && ((GUI_Slider*) node->component)->inc != NULL) {
+		GUI_ComponentNode *inc = GUI_FindComponent(context, ((GUI_Slider*) node->component)->inc);
+		GUI_ComponentNode *dec = GUI_FindComponent(context, ((GUI_Slider*) node->component)->dec);
+
+		if(inc != NULL)
+			GUI_HotSetFlag(&context->hot, inc, GUI_HOT_RETAINED, retained);
+		if(dec != NULL)
+			GUI_HotSetFlag(&context->hot, dec, GUI_HOT_RETAINED, retained);
+	}
+}
+static void GUI_InternalSetLayoutRoot(GUI_Context *context, GUI_ComponentNode *node, bool root) {
+	for(int i = 0; i < context->numLayoutRoots; i++) {
+		if(context->layoutRoots[i] == node) {
+			if(!root)
+				context->layoutRoots[i] = context->layoutRoots[--context->numLayoutRoots];
+			return;
+		}
+	}
+
+	if(root && !GUI_InternalReserve((void**) &context->layoutRoots, &context->layoutRootsCapacity, context->numLayoutRoots + 1, sizeof(GUI_ComponentNode*)))
+		context->layoutRoots[context->numLayoutRoots++] = node;
+}
+void GUI_Place(GUI_Context *context, void *component, int x, int y) {
+	GUI_ComponentNode *node = GUI_FindComponent(context, component);
+	if(node == NULL)
+		return;
+
+	// a container's children are placed wherever the layout puts them the next time it's updated
+	if(node->type == GUI_COMPONENT_CONTAINER) {
+		node->x = x;
+		node->y = y;
+		node->placed = true;
+		if(node->parent == NULL)
+			GUI_InternalSetLayoutRoot(context, node, true);
+
+		context->layoutDirty = true;
+		context->redraw = true;
+		return;
+	}
+
+	node->x = x;
+	node->y = y;
+	if(!node->placed)
+		node->bounds = (SDL_Rect) {x, y, 0, 0};
+	node->placed = true;
+	GUI_InternalSetRetained(context, node, true);
+
+	if(node->type == GUI_COMPONENT_BUTTON) {
+		((GUI_Button*) component)->x = x;
+		((GUI_Button*) component)->y = y;
+	}
+	else if(node->type == GUI_COMPONENT_SLIDER) {
+		((GUI_Slider*) component)->x = x;
+		((GUI_Slider*) component)->y = y;
+	}
+	else if(node->type == GUI_COMPONENT_LIST_VIEW) {
+		((GUI_ListView*) component)->x = x;
+		((GUI_ListView*) component)->y = y;
+	}
+
+	// components scrolled out of view don't take part in hit-testing at all
+	if(node->type == GUI_COMPONENT_BUTTON || node->type == GUI_COMPONENT_SLIDER || node->type == GUI_COMPONENT_LIST_VIEW) {
+		SDL_Rect bounds = GUI_InternalVisibleBounds(node);
+
+		if(bounds.w > 0 && bounds.h > 0)
+			GUI_HotMove(context, node, bounds.x, bounds.y, bounds.x + bounds.w, bounds.y + bounds.h);
+		else
+			GUI_GridRemove(&context->grid, node);
+	}
+
+	GUI_InternalMarkNodeDirty(context, node);
+}
+void GUI_Unplace(GUI_Context *context, void *component) {
+	GUI_ComponentNode *node = GUI_FindComponent(context, component);
+	if(node == NULL || !node->placed)
+		return;
+
+	SDL_UnionRect(&context->dirtyRect, &node->bounds, &context->dirtyRect);
+	context->dirty = true;
+	context->redraw = true;
+	node->placed = false;
+	GUI_InternalSetRetained(context, node, false);
+
+	if(node->type == GUI_COMPONENT_CONTAINER) {
+		GUI_Container *container = (GUI_Container*) component;
+
+		GUI_InternalSetLayoutRoot(context, node, false);
+		container->arrangeValid = false;
+		for(int i = 0; i < container->numChildren; i++) {
+			GUI_Unplace(context, container->children[i].node->component);
+		}
+	}
+}
+void GUI_MarkDirty(GUI_Context *context, void *component) {
+	GUI_ComponentNode *node = GUI_FindComponent(context, component);
+
+	if(node != NULL) {
+		GUI_InternalMarkNodeDirty(context, node);
+	}
+	else {
+		context->dirty = true;
+		context->redraw = true;
+		context->dirtyRect = (SDL_Rect) {0, 0, context->frameWidth, context->frameHeight};
+	}
+}
+void GUI_SetHidden(GUI_Context *context, void *component, bool hidden) {
+	GUI_ComponentNode *node = GUI_FindComponent(context, component);
+	if(node == NULL || node->hidden == hidden)
+		return;
+
+	GUI_InternalMarkNodeDirty(context, node);
+	GUI_InternalInvalidateLayout(context, node);
+	node->hidden = hidden;
+
+	if(hidden) {
+		if(node->type == GUI_COMPONENT_BUTTON) {
+			((GUI_Button*) component)->inside = false;
+			((GUI_Button*) component)->pressed = false;
+		}
+		else if(node->type == GUI_COMPONENT_SLIDER) {
+			((GUI_Slider*) component)->holding = false;
+		}
+		else if(node->type == GUI_COMPONENT_LIST_VIEW) {
+			((GUI_ListView*) component)->inside = false;
+		}
+
+		GUI_InternalSetActive(context, node, false);
+	}
+}
+// Layout: containers cache their measured size and the rectangle they were last arranged in. Changing a
+// component only invalidates the containers above it, so a relayout measures and arranges that branch
+// while every untouched container is skipped as soon as it's handed the same rectangle as last time.
+static void GUI_InternalInvalidateLayout(GUI_Context *context, GUI_ComponentNode *node) {
+	if(node->parent == NULL && node->type != GUI_COMPONENT_CONTAINER)
+		return;
+
+	if(node->type == GUI_COMPONENT_CONTAINER) {
+		((GUI_Container*) node->component)->measureValid = false;
+		((GUI_Container*) node->component)->arrangeValid = false;
+	}
+
+	// a container that's already invalid has invalidated everything above it too
+	for(GUI_ComponentNode *parent = node->parent; parent != NULL; parent = parent->parent) {
+		GUI_Container *container = (GUI_Container*) parent->component;
+		if(!container->measureValid && !container->arrangeValid)
+			break;
+
+		container->measureValid = false;
+		container->arrangeValid = false;
+	}
+
+	context->layoutDirty = true;
+	context->redraw = true;
+}
+static void GUI_InternalMeasure(GUI_Context *context, GUI_ComponentNode *node, int *width, int *height) {
+	if(node->type != GUI_COMPONENT_CONTAINER) {
+		SDL_Rect bounds = GUI_InternalNodeBounds(node);
+		*width = bounds.w;
+		*height = bounds.h;
+		return;
+	}
+
+	GUI_Container *container = (GUI_Container*) node->component;
+	if(!container->measureValid) {
+		int contentWidth = 0, contentHeight = 0, count = 0;
+		GUI_STAT_ADD(context, layoutVisits, 1);
+
+		container->cellWidth = 0;
+		container->cellHeight = 0;
+		for(int i = 0; i < container->numChildren; i++) {
+			GUI_LayoutChild *child = &container->children[i];
+			int childWidth, childHeight;
+
+			// hidden children don't take up any space
+			if(child->node->hidden)
+				continue;
+			GUI_InternalMeasure(context, child->node, &childWidth, &childHeight);
+
+			if(container->layout == GUI_LAYOUT_HSTACK) {
+				contentWidth += childWidth + (count > 0 ? container->spacing : 0);
+				contentHeight = SDL_max(contentHeight, childHeight);
+			}
+			else if(container->layout == GUI_LAYOUT_VSTACK) {
+				contentWidth = SDL_max(contentWidth, childWidth);
+				contentHeight += childHeight + (count > 0 ? container->spacing : 0);
+			}
+			else if(container->layout == GUI_LAYOUT_GRID) {
+				container->cellWidth = SDL_max(container->cellWidth, childWidth);
+				container->cellHeight = SDL_max(container->cellHeight, childHeight);
+			}
+			else {
+				contentWidth = SDL_max(contentWidth, childWidth + SDL_abs(child->offsetX));
+				contentHeight = SDL_max(contentHeight, childHeight + SDL_abs(child->offsetY));
+			}
+
+			count++;
+		}
+
+		if(container->layout == GUI_LAYOUT_GRID && count > 0) {
+			int columns = SDL_min(container->columns, count);
+			int rows = (count + container->columns - 1) / container->columns;
+
+			contentWidth = columns * container->cellWidth + (columns - 1) * container->spacing;
+			contentHeight = rows * container->cellHeight + (rows - 1) * container->spacing;
+		}
+
+		container->contentWidth = contentWidth + container->padding * 2;
+		container->contentHeight = contentHeight + container->padding * 2;
+		container->measuredWidth = container->width > 0 ? container->width : container->contentWidth;
+		container->measuredHeight = container->height > 0 ? container->height : container->contentHeight;
+		container->measureValid = true;
+	}
+
+	*width = container->measuredWidth;
+	*height = container->measuredHeight;
+}
+static int GUI_InternalAlign(int align, int start, int space, int size, int offset) {
+	if(align == 0)
+		return start + offset;
+	if(align == 1)
+		return start + (space - size) / 2 + offset;
+
+	return start + space - size - offset;
+}
+static void GUI_InternalArrange(GUI_Context *context, GUI_ComponentNode *node, int x, int y, bool reclip);
+// reclip places components again even if they didn't move, because the area clipping them changed
+static void GUI_InternalMoveNode(GUI_Context *context, GUI_ComponentNode *node, bool placed, int x, int y, bool reclip) {
+	if(node->type == GUI_COMPONENT_CONTAINER) {
+		if(node->placed != placed || reclip)
+			((GUI_Container*) node->component)->arrangeValid = false;
+		node->placed = placed;
+		GUI_InternalArrange(context, node, x, y, reclip);
+		return;
+	}
+
+	// components are moved so their bounds start at the position, sliders' bounds reach past their position
+	SDL_Rect bounds = GUI_InternalNodeBounds(node);
+	x += node->x - bounds.x;
+	y += node->y - bounds.y;
+
+	if(placed) {
+		if(!node->placed || node->x != x || node->y != y || reclip)
+			GUI_Place(context, node->component, x, y);
+	}
+	else {
+		node->x = x;
+		node->y = y;
+	}
+}
+static void GUI_InternalArrange(GUI_Context *context, GUI_ComponentNode *node, int x, int y, bool reclip) {
+	GUI_Container *container = (GUI_Container*) node->component;
+	int width, height;
+
+	GUI_InternalMeasure(context, node, &width, &height);
+	if(container->arrangeValid && container->rect.x == x && container->rect.y == y && container->rect.w == width && container->rect.h == height)
+		return;
+
+	// a clipping container only changes what its children show when its own rect changes; scrolling moves
+	// every child, so they're placed again either way
+	if(container->clip && (container->rect.x != x || container->rect.y != y || container->rect.w != width || container->rect.h != height))
+		reclip = true;
+
+	GUI_STAT_ADD(context, layoutVisits, 1);
+	container->rect = (SDL_Rect) {x, y, width, height};
+	node->x = x;
+	node->y = y;
+
+	// a scrolled container moves its content up and to the left, as far as the content reaches
+	container->scrollX = SDL_max(0, SDL_min(container->scrollX, container->contentWidth - width));
+	container->scrollY = SDL_max(0, SDL_min(container->scrollY, container->contentHeight - height));
+
+	int innerX = x + container->padding - container->scrollX, innerY = y + container->padding - container->scrollY;
+	int innerWidth = width - container->padding * 2, innerHeight = height - container->padding * 2;
+	int index = 0;
+
+	for(int i = 0; i < container->numChildren; i++) {
+		GUI_LayoutChild *child = &container->children[i];
+		int childWidth, childHeight, childX, childY;
+
+		if(child->node->hidden)
+			continue;
+		GUI_InternalMeasure(context, child->node, &childWidth, &childHeight);
+
+		if(container->layout == GUI_LAYOUT_HSTACK) {
+			childX = innerX;
+			childY = innerY;
+			innerX += childWidth + container->spacing;
+		}
+		else if(container->layout == GUI_LAYOUT_VSTACK) {
+			childX = innerX;
+			childY = innerY;
+			innerY += childHeight + container->spacing;
+		}
+		else if(container->layout == GUI_LAYOUT_GRID) {
+			childX = innerX + (index % container->columns) * (container->cellWidth + container->spacing);
+			childY = innerY + (index / container->columns) * (container->cellHeight + container->spacing);
+		}
+		else {
+			childX = GUI_InternalAlign(child->anchor % 3, innerX, innerWidth, childWidth, child->offsetX);
+			childY = GUI_InternalAlign(child->anchor / 3, innerY, innerHeight, childHeight, child->offsetY);
+		}
+
+		GUI_InternalMoveNode(context, child->node, node->placed, childX, childY, reclip);
+		index++;
+	}
+
+	container->arrangeValid = true;
+}
+static void GUI_InternalUpdateLayout(GUI_Context *context) {
+	if(!context->layoutDirty)
+		return;
+
+	for(int i = 0; i < context->numLayoutRoots; i++) {
+		GUI_InternalArrange(context, context->layoutRoots[i], context->layoutRoots[i]->x, context->layoutRoots[i]->y, false);
+	}
+
+	context->layoutDirty = false;
+}
+static void GUI_InternalResize(GUI_Context *context, int width, int height) {
+	if(width == context->width && height == context->height)
+		return;
+
+	context->width = width;
+	context->height = height;
+	context->redraw = true;
+
+	// the hit-test grid covers the window, so everything in it is inserted again where the hot store has it
+	GUI_HotStore *hot = &context->hot;
+	GUI_GridDestroy(&context->grid);
+	GUI_GridInit(&context->grid, width, height, GUI_GRID_CELL_SIZE);
+	for(int i = 0; i < hot->count; i++) {
+		if(hot->nodes[i]->gridX0 < 0)
+			continue;
+
+		hot->nodes[i]->gridX0 = -1;
+		GUI_GridMove(&context->grid, hot->nodes[i], hot->x0[i], hot->y0[i], hot->x1[i], hot->y1[i]);
+	}
+
+	if(context->root != NULL) {
+		GUI_Container *root = (GUI_Container*) context->root->component;
+		root->width = width;
+		root->height = height;
+		GUI_InternalInvalidateLayout(context, context->root);
+	}
+}
+bool GUI_NeedsRedraw(GUI_Context *context) {
+	return context->dirty;
+}
+void GUI_Render(GUI_Context *context) {
+	int width, height;
+	SDL_GetRendererOutputSize(context->render, &width, &height);
+	GUI_InternalUpdateLayout(context);
+	GUI_Flush(context);
+
+	if(!context->directDraw && (context->frame == NULL || context->frameWidth != width || context->frameHeight != height)) {
+		if(context->frame != NULL) {
+			SDL_DestroyTexture(context->frame);
+			GUI_STAT_ADD(context, texturesDestroyed, 1);
+		}
+
+		context->frame = SDL_CreateTexture(context->render, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+		GUI_STAT_ADD(context, texturesCreated, context->frame != NULL);
+		context->frameWidth = width;
+		context->frameHeight = height;
+		context->dirty = true;
+		context->dirtyRect = (SDL_Rect) {0, 0, width, height};
+
+		// the frame holds colors already multiplied by their alpha, so it's composited with premultiplied blending;
+		// renderers that can't do that blend would darken every translucent edge, so those draw directly instead
+		if(context->frame != NULL && SDL_SetTextureBlendMode(context->frame, SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD, SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD)) != 0) {
+			SDL_DestroyTexture(context->frame);
+			GUI_STAT_ADD(context, texturesDestroyed, 1);
+			context->frame = NULL;
+			context->directDraw = true;
+		}
+	}
+
+	if(context->frame == NULL) {
+		// without render target support everything placed on screen is drawn directly every frame
+		SDL_Rect full = (SDL_Rect) {0, 0, width, height};
+
+		for(GUI_ComponentNode *node = context->components; node != NULL; node = node->next) {
+			if(node->placed && !GUI_InternalNodeHidden(node)) {
+				node->bounds = GUI_InternalVisibleBounds(node);
+				if(SDL_HasIntersection(&node->bounds, &full))
+					GUI_InternalDrawVisible(context, node, NULL);
+			}
+		}
+
+		context->dirty = false;
+		context->dirtyRect = (SDL_Rect) {0, 0, 0, 0};
+		GUI_InternalEndDraw(context);
+		return;
+	}
+
+	if(context->dirty) {
+		SDL_Rect full = (SDL_Rect) {0, 0, width, height};
+		SDL_Rect area;
+
+		if(SDL_IntersectRect(&context->dirtyRect, &full, &area)) {
+			SDL_Texture *target = SDL_GetRenderTarget(context->render);
+			SDL_BlendMode blendMode;
+
+			SDL_SetRenderTarget(context->render, context->frame);
+			GUI_STAT_ADD(context, renderCalls, 1);
+			SDL_RenderSetClipRect(context->render, &area);
+			GUI_STAT_ADD(context, renderCalls, 1);
+
+			// the changed area is cleared to transparent, which the draw list's blended quads can't do
+			SDL_GetRenderDrawBlendMode(context->render, &blendMode);
+			SDL_SetRenderDrawBlendMode(context->render, SDL_BLENDMODE_NONE);
+			GUI_STAT_ADD(context, renderCalls, 1);
+			SDL_SetRenderDrawColor(context->render, 0, 0, 0, 0);
+			GUI_STAT_ADD(context, renderCalls, 1);
+			SDL_RenderFillRect(context->render, &area);
+			GUI_STAT_ADD(context, renderCalls, 1);
+			SDL_SetRenderDrawBlendMode(context->render, blendMode);
+			GUI_STAT_ADD(context, renderCalls, 1);
+
+			for(GUI_ComponentNode *node = context->components; node != NULL; node = node->next) {
+				if(!node->placed || GUI_InternalNodeHidden(node))
+					continue;
+
+				node->bounds = GUI_InternalVisibleBounds(node);
+				if(SDL_HasIntersection(&node->bounds, &area))
+					GUI_InternalDrawVisible(context, node, &area);
+			}
+
+			GUI_Flush(context);
+			SDL_RenderSetClipRect(context->render, NULL);
+			GUI_STAT_ADD(context, renderCalls, 1);
+			SDL_SetRenderTarget(context->render, target);
+			GUI_STAT_ADD(context, renderCalls, 1);
+		}
+
+		context->dirty = false;
+		context->dirtyRect = (SDL_Rect) {0, 0, 0, 0};
+	}
+
+	SDL_Rect rect = (SDL_Rect) {0, 0, width, height};
+	GUI_InternalPushTexture(context, context->frame, NULL, 0, 0, &rect);
+	GUI_InternalEndDraw(context);
+}
+
+GUI_Container* GUI_NewContainer(GUI_Context *context, GUI_LayoutType layout, int width, int height, int padding, int spacing, int columns) {
+	GUI_Container *container = (GUI_Container*) calloc(1, sizeof(GUI_Container));
+
+	container->layout = layout;
+	container->width = width;
+	container->height = height;
+	container->padding = padding;
+	container->spacing = spacing;
+	container->columns = columns > 0 ? columns : 1;
+
+	if(GUI_SerializeComponent(context, container, GUI_COMPONENT_CONTAINER)) {
+		GUI_FreeContainer(context, container);
+		return NULL;
+	}
+	return container;
+}
+void GUI_FreeContainer(GUI_Context *context, GUI_Container *container) {
+	if(container->hSlider != NULL)
+		container->hSlider->target = NULL;
+	if(container->vSlider != NULL)
+		container->vSlider->target = NULL;
+
+	if(container->children != NULL)
+		free(container->children);
+	free(container);
+}
+bool GUI_AddAnchoredChild(GUI_Context *context, GUI_Container *container, void *component, GUI_Anchor anchor, int offsetX, int offsetY) {
+	GUI_ComponentNode *node = GUI_FindComponent(context, container);
+	GUI_ComponentNode *child = GUI_FindComponent(context, component);
+
+	if(node == NULL || child == NULL || child == node || child->parent != NULL)
+		return true;
+
+	// a container can't end up inside itself
+	for(GUI_ComponentNode *parent = node->parent; parent != NULL; parent = parent->parent) {
+		if(parent == child)
+			return true;
+	}
+
+	if(GUI_InternalReserve((void**) &container->children, &container->childrenCapacity, container->numChildren + 1, sizeof(GUI_LayoutChild)))
+		return true;
+
+	container->children[container->numChildren++] = (GUI_LayoutChild) {child, anchor, offsetX, offsetY};
+	child->parent = node;
+	if(child->type == GUI_COMPONENT_CONTAINER)
+		GUI_InternalSetLayoutRoot(context, child, false);
+
+	GUI_InternalInvalidateLayout(context, node);
+	return false;
+}
+bool GUI_AddChild(GUI_Context *context, GUI_Container *container, void *component) {
+	return GUI_AddAnchoredChild(context, container, component, GUI_ANCHOR_TOP_LEFT, 0, 0);
+}
+bool GUI_RemoveChild(GUI_Context *context, GUI_Container *container, void *component) {
+	GUI_ComponentNode *node = GUI_FindComponent(context, container);
+	if(node == NULL)
+		return true;
+
+	for(int i = 0; i < container->numChildren; i++) {
+		GUI_ComponentNode *child = container->children[i].node;
+		if(child->component != component)
+			continue;
 
-	GUI_SerializeComponent(context, slider, GUI_COMPONENT_SLIDER);
-	GUI_AddEvent(context, slider, &GUI_InternalSliderEvent, GUI_SLIDER_INTERNAL);
-	return slider;
+		memmove(&container->children[i], &container->children[i + 1], (container->numChildren - i - 1) * sizeof(GUI_LayoutChild));
+		container->numChildren--;
+		child->parent = NULL;
+
+		// whatever the container placed goes away with it
+		GUI_Unplace(context, component);
+		GUI_InternalInvalidateLayout(context, node);
+		return false;
+	}
+
+	return true;
 }
-void GUI_FreeSlider(GUI_Context *context, GUI_Slider *slider) {
-	free(slider);
+void GUI_SetContainerSize(GUI_Context *context, GUI_Container *container, int width, int height) {
+	GUI_ComponentNode *node = GUI_FindComponent(context, container);
+	if(node == NULL || (container->width == width && container->height == height))
+		return;
+
+	container->width = width;
+	container->height = height;
+	GUI_InternalInvalidateLayout(context, node);
 }
-void GUI_DrawSlider(GUI_Context *context, GUI_Slider *slider, int x, int y) {
-	slider->onScreen = true;
-	slider->x = x;
-	slider->y = y;
+void GUI_SetRootContainer(GUI_Context *context, GUI_Container *container) {
+	GUI_ComponentNode *node = container != NULL ? GUI_FindComponent(context, container) : NULL;
 
-	SDL_Rect rect;
-	rect.x = x;
-	rect.y = y;
+	context->root = node;
+	if(node == NULL)
+		return;
 
-	if(slider->vertical) {
-		rect.w = slider->width;
-		rect.h = slider->length;
-	}
-	else {
-		rect.w = slider->length;
-		rect.h = slider->width;
-	}
+	container->width = context->width;
+	container->height = context->height;
+	GUI_InternalInvalidateLayout(context, node);
+}
+void GUI_InvalidateLayout(GUI_Context *context, void *component) {
+	GUI_ComponentNode *node = GUI_FindComponent(context, component);
 
-	SDL_SetRenderDrawColor(context->render, slider->sliderColor.r, slider->sliderColor.g, slider->sliderColor.b, slider->sliderColor.a);
-	SDL_RenderFillRect(context->render, &rect);
+	if(node != NULL)
+		GUI_InternalInvalidateLayout(context, node);
+}
+// children outside of the clip rectangle are skipped, so they're neither drawn nor see any input
+static void GUI_InternalDrawChildren(GUI_Context *context, GUI_Container *container, SDL_Rect *clip) {
+	SDL_Rect *outer = clip, inner;
 
-	if(slider->vertical) {
-		rect.x = x - slider->width;
-		rect.y = y + slider->length - slider->width - (slider->length - slider->width) * slider->value;
-		rect.w = slider->width * 3;
-		rect.h = slider->width;
-	}
-	else {
-		rect.x = x + (slider->length - slider->width) * slider->value;
-		rect.y = y - slider->width;
-		rect.w = slider->width;
-		rect.h = slider->width * 3;
+	if(container->clip) {
+		if(clip != NULL && !SDL_IntersectRect(&container->rect, clip, &inner))
+			return;
+		else if(clip == NULL)
+			inner = container->rect;
+
+		clip = &inner;
+		GUI_Flush(context);
+		SDL_RenderSetClipRect(context->render, clip);
+		GUI_STAT_ADD(context, renderCalls, 1);
 	}
 
-	SDL_SetRenderDrawColor(context->render, slider->handleColor.r, slider->handleColor.g, slider->handleColor.b, slider->handleColor.a);
-	SDL_RenderFillRect(context->render, &rect);
+	for(int i = 0; i < container->numChildren; i++) {
+		GUI_ComponentNode *child = container->children[i].node;
 
-	if(slider->inc != NULL) {
-		if(slider->vertical) {
-			GUI_DrawButton(context, slider->inc, x - (slider->inc->width - slider->width) / 2, y - slider->inc->height - slider->width);
-			GUI_DrawButton(context, slider->dec, x - (slider->inc->width - slider->width) / 2, y + slider->length + slider->width);
+		if(child->hidden)
+			continue;
+
+		if(child->type == GUI_COMPONENT_CONTAINER) {
+			GUI_InternalDrawChildren(context, (GUI_Container*) child->component, clip);
 		}
 		else {
-			GUI_DrawButton(context, slider->dec, x - slider->dec->width - slider->width, y - (slider->dec->height - slider->width) / 2);
-			GUI_DrawButton(context, slider->inc, x + slider->length + slider->width, y - (slider->inc->height - slider->width) / 2);
+			SDL_Rect bounds = GUI_InternalNodeBounds(child);
+			if(clip == NULL || SDL_HasIntersection(&bounds, clip))
+				GUI_InternalDrawNode(context, child);
 		}
 	}
+
+	if(container->clip) {
+		GUI_Flush(context);
+		SDL_RenderSetClipRect(context->render, outer);
+		GUI_STAT_ADD(context, renderCalls, 1);
+	}
+}
+void GUI_DrawContainer(GUI_Context *context, GUI_Container *container, int x, int y) {
+	GUI_ComponentNode *node = GUI_FindComponent(context, container);
+	if(node == NULL || GUI_InternalNodeHidden(node))
+		return;
+
+	// a clip rect set by the host also clips the container, and is put back once a panel is done with it
+	SDL_Rect hostClip;
+	bool hostClipped = SDL_RenderIsClipEnabled(context->render);
+	if(hostClipped)
+		SDL_RenderGetClipRect(context->render, &hostClip);
+
+	GUI_InternalArrange(context, node, x, y, false);
+	GUI_InternalDrawChildren(context, container, hostClipped ? &hostClip : NULL);
+	GUI_InternalEndDraw(context);
+}
+GUI_Container* GUI_NewScrollPanel(GUI_Context *context, GUI_LayoutType layout, int width, int height, int padding, int spacing, int columns) {
+	GUI_Container *container = GUI_NewContainer(context, layout, width, height, padding, spacing, columns);
+
+	if(container != NULL)
+		container->clip = true;
+	return container;
+}
+static void GUI_InternalScrollContainer(GUI_Context *context, GUI_Container *container, int scrollX, int scrollY, GUI_Slider *source) {
+	GUI_ComponentNode *node = GUI_FindComponent(context, container);
+	int width, height;
+	if(node == NULL)
+		return;
+
+	GUI_InternalMeasure(context, node, &width, &height);
+	int maxX = SDL_max(0, container->contentWidth - width), maxY = SDL_max(0, container->contentHeight - height);
+
+	scrollX = SDL_max(0, SDL_min(scrollX, maxX));
+	scrollY = SDL_max(0, SDL_min(scrollY, maxY));
+	if(scrollX == container->scrollX && scrollY == container->scrollY)
+		return;
+
+	container->scrollX = scrollX;
+	container->scrollY = scrollY;
+
+	// scrolling doesn't change any sizes, so only the containers down to this one are arranged again
+	for(GUI_ComponentNode *parent = node; parent != NULL; parent = parent->parent) {
+		((GUI_Container*) parent->component)->arrangeValid = false;
+	}
+	context->layoutDirty = true;
+	context->redraw = true;
+
+	if(container->hSlider != NULL && container->hSlider != source)
+		GUI_SetSliderValue(context, container->hSlider, maxX > 0 ? (float) scrollX / maxX : 0.0f);
+	if(container->vSlider != NULL && container->vSlider != source)
+		GUI_SetSliderValue(context, container->vSlider, 1.0f - (maxY > 0 ? (float) scrollY / maxY : 0.0f));
+}
+void GUI_ScrollContainer(GUI_Context *context, GUI_Container *container, int scrollX, int scrollY) {
+	GUI_InternalScrollContainer(context, container, scrollX, scrollY, NULL);
+}
+void GUI_SetScrollSlider(GUI_Context *context, GUI_Container *container, GUI_Slider *slider) {
+	GUI_ComponentNode *node = GUI_FindComponent(context, container);
+	if(node == NULL || slider == NULL)
+		return;
+
+	GUI_Slider **linked = slider->vertical ? &container->vSlider : &container->hSlider;
+	if(*linked != NULL)
+		GUI_InternalUnlinkSlider(*linked);
+	GUI_InternalUnlinkSlider(slider);
+
+	*linked = slider;
+	slider->target = node;
+
+	int width, height;
+	GUI_InternalMeasure(context, node, &width, &height);
+	if(slider->vertical)
+		GUI_SetSliderValue(context, slider, 1.0f - (container->contentHeight > height ? (float) container->scrollY / (container->contentHeight - height) : 0.0f));
+	else
+		GUI_SetSliderValue(context, slider, container->contentWidth > width ? (float) container->scrollX / (container->contentWidth - width) : 0.0f);
 }
 
 bool GUI_IsPointInsideRect(int mx, int my, int x, int y, int w, int h) {
@@ -376,211 +3654,591 @@ bool GUI_IsPointInsideRect(int mx, int my, int x, int y, int w, int h) {
 
 	return false;
 }
-bool GUI_AddEvent(GUI_Context *context, void* component, GUI_Event event, GUI_EventType type) {
-	GUI_ComponentNode *compNode = context->components;
 
-	while(compNode != NULL && compNode->component != component) {
-		compNode = compNode->next;
+// Every kernel tests the rects from start on and sets a bit in mask for each one containing the point,
+// edges included the same way as GUI_IsPointInsideRect. The vector kernels leave the rest to the scalar one.
+typedef void (*GUI_HitKernel)(int mx, int my, const int *x0, const int *y0, const int *x1, const int *y1, int start, int count, Uint32 *mask);
+
+static void GUI_InternalHitScalar(int mx, int my, const int *x0, const int *y0, const int *x1, const int *y1, int start, int count, Uint32 *mask) {
+	for(int i = start; i < count; i++) {
+		if(mx >= x0[i] && my >= y0[i] && mx <= x1[i] && my <= y1[i])
+			mask[i / 32] |= (Uint32) 1 << (i % 32);
 	}
+}
+#ifdef GUI_HIT_SSE2
+static void GUI_InternalHitSSE2(int mx, int my, const int *x0, const int *y0, const int *x1, const int *y1, int start, int count, Uint32 *mask) {
+	__m128i x = _mm_set1_epi32(mx), y = _mm_set1_epi32(my);
+	int i = start;
 
-	if(compNode == NULL) {
-		return true;
+	for(; i + 4 <= count; i += 4) {
+		__m128i outside = _mm_or_si128(_mm_cmpgt_epi32(_mm_loadu_si128((const __m128i*) (x0 + i)), x), _mm_cmpgt_epi32(x, _mm_loadu_si128((const __m128i*) (x1 + i))));
+		outside = _mm_or_si128(outside, _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i*) (y0 + i)), y));
+		outside = _mm_or_si128(outside, _mm_cmpgt_epi32(y, _mm_loadu_si128((const __m128i*) (y1 + i))));
+
+		mask[i / 32] |= (Uint32) (~_mm_movemask_ps(_mm_castsi128_ps(outside)) & 0xf) << (i % 32);
 	}
-	GUI_EventNode **node = &compNode->events;
-	GUI_EventNode *prev = NULL;
 
-	if(type == GUI_BUTTON_ON_PRESS || type == GUI_BUTTON_ON_RELEASE || type == GUI_BUTTON_ON_ENTER || type == GUI_BUTTON_ON_EXIT) {
-		if(compNode->type != GUI_COMPONENT_BUTTON) {
-			return true;
-		}
+	GUI_InternalHitScalar(mx, my, x0, y0, x1, y1, i, count, mask);
+}
+#endif
+#ifdef GUI_HIT_AVX2
+static GUI_HIT_AVX2_TARGET void GUI_InternalHitAVX2(int mx, int my, const int *x0, const int *y0, const int *x1, const int *y1, int start, int count, Uint32 *mask) {
+	__m256i x = _mm256_set1_epi32(mx), y = _mm256_set1_epi32(my);
+	int i = start;
+
+	for(; i + 8 <= count; i += 8) {
+		__m256i outside = _mm256_or_si256(_mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i*) (x0 + i)), x), _mm256_cmpgt_epi32(x, _mm256_loadu_si256((const __m256i*) (x1 + i))));
+		outside = _mm256_or_si256(outside, _mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i*) (y0 + i)), y));
+		outside = _mm256_or_si256(outside, _mm256_cmpgt_epi32(y, _mm256_loadu_si256((const __m256i*) (y1 + i))));
+
+		mask[i / 32] |= (Uint32) (~_mm256_movemask_ps(_mm256_castsi256_ps(outside)) & 0xff) << (i % 32);
 	}
-	else if(type == GUI_SLIDER_INTERNAL || type == GUI_SLIDER_ON_HOLD || type == GUI_SLIDER_ON_RELEASE) {
-		if(compNode->type != GUI_COMPONENT_SLIDER) {
-			return true;
-		}
+
+	// leaving the upper halves of the registers dirty slows down all SSE code that runs after this
+	_mm256_zeroupper();
+	GUI_InternalHitScalar(mx, my, x0, y0, x1, y1, i, count, mask);
+}
+#endif
+#ifdef GUI_HIT_NEON
+static void GUI_InternalHitNEON(int mx, int my, const int *x0, const int *y0, const int *x1, const int *y1, int start, int count, Uint32 *mask) {
+	static const uint32_t lanes[4] = {1, 2, 4, 8};
+	int32x4_t x = vdupq_n_s32(mx), y = vdupq_n_s32(my);
+	uint32x4_t bits = vld1q_u32(lanes);
+	int i = start;
+
+	for(; i + 4 <= count; i += 4) {
+		uint32x4_t inside = vandq_u32(vcleq_s32(vld1q_s32(x0 + i), x), vcleq_s32(x, vld1q_s32(x1 + i)));
+		inside = vandq_u32(inside, vcleq_s32(vld1q_s32(y0 + i), y));
+		inside = vandq_u32(inside, vcleq_s32(y, vld1q_s32(y1 + i)));
+
+		uint32x2_t sum = vpadd_u32(vget_low_u32(vandq_u32(inside, bits)), vget_high_u32(vandq_u32(inside, bits)));
+		mask[i / 32] |= vget_lane_u32(vpadd_u32(sum, sum), 0) << (i % 32);
 	}
-	else {
-		return true;
+
+	GUI_InternalHitScalar(mx, my, x0, y0, x1, y1, i, count, mask);
+}
+#endif
+static GUI_HitKernel GUI_InternalHitKernel(void) {
+	static GUI_HitKernel kernel = NULL;
+
+	// picking the same kernel twice from two threads is harmless
+	if(kernel == NULL) {
+		kernel = &GUI_InternalHitScalar;
+#ifdef GUI_HIT_NEON
+		kernel = &GUI_InternalHitNEON;
+#endif
+#ifdef GUI_HIT_SSE2
+		kernel = &GUI_InternalHitSSE2;
+#endif
+#ifdef GUI_HIT_AVX2
+		if(SDL_HasAVX2())
+			kernel = &GUI_InternalHitAVX2;
+#endif
 	}
-	
-	while(*node != NULL) {
-		prev = *node;
-		node = &(*node)->next;
+
+	return kernel;
+}
+static int GUI_InternalLowestBit(Uint32 bits) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctz(bits);
+#else
+	int bit = 0;
+	for(; !(bits & 1); bits >>= 1) {
+		bit++;
 	}
+	return bit;
+#endif
+}
+void GUI_HitTestRects(int mx, int my, const int *x0, const int *y0, const int *x1, const int *y1, int count, Uint32 *mask) {
+	memset(mask, 0, (count + 31) / 32 * sizeof(Uint32));
+	GUI_InternalHitKernel()(mx, my, x0, y0, x1, y1, 0, count, mask);
+}
+static bool GUI_InternalHitTest(GUI_Context *context, GUI_ComponentNode *node, int mx, int my, int x, int y, int w, int h) {
+	SDL_Rect clip;
+	GUI_STAT_ADD(context, hitTests, 1);
 
-	*node = (GUI_EventNode*) malloc(sizeof(GUI_EventNode));
-	(*node)->type = type;
-	(*node)->event = event;
-	(*node)->prev = prev;
-	(*node)->next = NULL;
+	// the parts of a component cut off by a clipping container can't be clicked
+	if(node->parent != NULL && GUI_InternalNodeClip(node, &clip) && !GUI_IsPointInsideRect(mx, my, clip.x, clip.y, clip.w, clip.h))
+		return false;
 
-	return false;
+	return GUI_IsPointInsideRect(mx, my, x, y, w, h);
 }
-bool GUI_ClearEvents(GUI_Context *context, void *component) {
-	GUI_ComponentNode *compNode = context->components;
+bool GUI_AddEvent(GUI_Context *context, void* component, GUI_Event event, GUI_EventType type) {
+	GUI_ComponentNode *compNode = GUI_FindComponent(context, component);
 
-	while(compNode != NULL && compNode->component != component) {
-		compNode = compNode->next;
+	if(compNode == NULL) {
+		return true;
 	}
 
-	if(compNode == NULL)
+	int bucket = GUI_InternalEventBucket(compNode->type, type);
+	if(bucket < 0) {
 		return true;
+	}
+
+	GUI_EventList *list = &compNode->events[bucket];
+	if(list->count == list->capacity) {
+		GUI_Event *events;
+
+		if(list->events == list->inlineEvents) {
+			events = (GUI_Event*) malloc(list->capacity * 2 * sizeof(GUI_Event));
+			if(events != NULL)
+				memcpy(events, list->inlineEvents, list->count * sizeof(GUI_Event));
+		}
+		else {
+			events = (GUI_Event*) realloc(list->events, list->capacity * 2 * sizeof(GUI_Event));
+		}
+
+		if(events == NULL)
+			return true;
 
-	while(compNode->events != NULL) {
-		GUI_EventNode *next = compNode->events->next;
-		free(compNode->events);
-		compNode->events = next;
+		list->events = events;
+		list->capacity *= 2;
 	}
 
+	list->events[list->count++] = event;
 	return false;
 }
-bool GUI_RemoveEvent(GUI_Context *context, void *component, GUI_Event event, GUI_EventType type) {
-	GUI_ComponentNode *compNode = context->components;
-
-	while(compNode != NULL && compNode->component != component) {
-		compNode = compNode->next;
-	}
+bool GUI_ClearEvents(GUI_Context *context, void *component) {
+	GUI_ComponentNode *compNode = GUI_FindComponent(context, component);
 
 	if(compNode == NULL)
 		return true;
 
-	GUI_EventNode *eventNode = compNode->events;
-	while(eventNode != NULL && !(eventNode->type == type && eventNode->event == event)) {
-		eventNode = eventNode->next;
-	}
+	GUI_InternalClearNodeEvents(compNode);
+	return false;
+}
+bool GUI_RemoveEvent(GUI_Context *context, void *component, GUI_Event event, GUI_EventType type) {
+	GUI_ComponentNode *compNode = GUI_FindComponent(context, component);
 
-	if(eventNode == NULL)
+	if(compNode == NULL)
 		return true;
 
-	if(eventNode->prev != NULL) {
-		eventNode->prev->next = eventNode->next;
+	int bucket = GUI_InternalEventBucket(compNode->type, type);
+	if(bucket < 0)
+		return true;
 
-		if(eventNode->next != NULL)
-			eventNode->next->prev = eventNode->prev;
-	}
-	else {
-		eventNode->next->prev = NULL;
+	GUI_EventList *list = &compNode->events[bucket];
+	int i = 0;
+	while(i < list->count && list->events[i] != event) {
+		i++;
 	}
 
-	free(eventNode);
+	if(i == list->count)
+		return true;
+
+	// callbacks keep the order they were added in
+	memmove(&list->events[i], &list->events[i + 1], (list->count - i - 1) * sizeof(GUI_Event));
+	list->count--;
 	return false;
 }
 bool GUI_TriggerEvents(GUI_Context *context, void *component, GUI_EventType type) {
-	GUI_ComponentNode *compNode = context->components;
-	while(compNode != NULL && compNode->component != component) {
-		compNode = compNode->next;
-	}
+	GUI_ComponentNode *compNode = GUI_FindComponent(context, component);
 
 	if(compNode == NULL)
 		return true;
 
-	GUI_EventNode *eventNode = compNode->events;
-	while(eventNode != NULL) {
-		if(eventNode->type == type)
-			eventNode->event(component);
-
-		eventNode = eventNode->next;
-	}
-
+	GUI_InternalTriggerNode(context, compNode, type);
 	return false;
 }
-bool GUI_Update(GUI_Context *context, SDL_Event event) {
-	GUI_ComponentNode *compNode = context->components;
+static bool GUI_InternalUpdateComponent(GUI_Context *context, GUI_ComponentNode *node, SDL_Event event) {
 	bool handled = false;
+	context->hot.visited[node->hotIndex] = context->updateCount;
+	GUI_STAT_ADD(context, componentsVisited, 1);
 
-	while(compNode != NULL) {
-		if(compNode->type == GUI_COMPONENT_BUTTON) {
-			GUI_Button *button = (GUI_Button*) compNode->component;
-			if(button->onScreen)
-				button->onScreen = false;
-			else
-				goto next;
-
-			if(event.type == SDL_MOUSEBUTTONDOWN) {
-				if(GUI_IsPointInsideRect(event.button.x, event.button.y, button->x, button->y, button->width, button->height)) {
-					handled = true;
-					button->pressed = true;
-					GUI_TriggerEvents(context, button, GUI_BUTTON_ON_PRESS);
-				}
+	// components only see input while they're placed, or drawn since the last update
+	if(!(context->hot.flags[node->hotIndex] & (GUI_HOT_ON_SCREEN | GUI_HOT_RETAINED)) || GUI_InternalNodeHidden(node))
+		return false;
+
+	if(node->type == GUI_COMPONENT_BUTTON) {
+		GUI_Button *button = (GUI_Button*) node->component;
+
+		if(event.type == SDL_MOUSEBUTTONDOWN) {
+			if(GUI_InternalHitTest(context, node, event.button.x, event.button.y, button->x, button->y, button->width, button->height)) {
+				handled = true;
+				button->pressed = true;
+				GUI_InternalTriggerNode(context, node, GUI_BUTTON_ON_PRESS);
 			}
-			else if(event.type == SDL_MOUSEBUTTONUP && button->pressed) {
+		}
+		else if(event.type == SDL_MOUSEBUTTONUP && button->pressed) {
+			handled = true;
+			button->pressed = false;
+			GUI_InternalTriggerNode(context, node, GUI_BUTTON_ON_RELEASE);
+		}
+		else if(event.type == SDL_MOUSEMOTION) {
+			if(!button->inside && GUI_InternalHitTest(context, node, event.motion.x, event.motion.y, button->x, button->y, button->width, button->height)) {
 				handled = true;
-				button->pressed = false;
-				GUI_TriggerEvents(context, button, GUI_BUTTON_ON_RELEASE);
+				button->inside = true;
+				GUI_InternalTriggerNode(context, node, GUI_BUTTON_ON_ENTER);
 			}
-			else if(event.type == SDL_MOUSEMOTION) {
-				if(!button->inside && GUI_IsPointInsideRect(event.motion.x, event.motion.y, button->x, button->y, button->width, button->height)) {
-					handled = true;
-					button->inside = true;
-					GUI_TriggerEvents(context, button, GUI_BUTTON_ON_ENTER);
-				}
-				else if(button->inside && (event.motion.x < button->x || event.motion.y < button->y || event.motion.x > button->x + button->width || event.motion.y > button->y + button->height)) {
-					handled = true;
-					button->inside = false;
-					GUI_TriggerEvents(context, button, GUI_BUTTON_ON_EXIT);
-				}
+			else if(button->inside && !GUI_InternalHitTest(context, node, event.motion.x, event.motion.y, button->x, button->y, button->width, button->height)) {
+				handled = true;
+				button->inside = false;
+				GUI_InternalTriggerNode(context, node, GUI_BUTTON_ON_EXIT);
 			}
 		}
-		else if(compNode->type == GUI_COMPONENT_SLIDER) {
-			GUI_Slider *slider = (GUI_Slider*) compNode->component;
 
-			if(slider->onScreen)
-				slider->onScreen = false;
-			else
-				goto next;
+		GUI_InternalSetActive(context, node, button->inside || button->pressed);
+	}
+	else if(node->type == GUI_COMPONENT_SLIDER) {
+		GUI_Slider *slider = (GUI_Slider*) node->component;
+		float previous = slider->value;
 
-			if(event.type == SDL_MOUSEBUTTONDOWN && !slider->holding) {
-				SDL_Rect rect;
+		if(event.type == SDL_MOUSEBUTTONDOWN && !slider->holding) {
+			SDL_Rect rect;
 
-				if(slider->vertical) {
-					rect.x = slider->x - slider->width;
-					rect.y = slider->y + slider->length - slider->width - (slider->length - slider->width) * slider->value;
-					rect.w = slider->width * 3;
-					rect.h = slider->width;
-				}
-				else {	
-					rect.x = slider->x + (slider->length - slider->width) * slider->value;
-					rect.y = slider->y - slider->width;
-					rect.w = slider->width;
-					rect.h = slider->width * 3;
-				}
+			if(slider->vertical) {
+				rect.x = slider->x - slider->width;
+				rect.y = slider->y + slider->length - slider->width - (slider->length - slider->width) * slider->value;
+				rect.w = slider->width * 3;
+				rect.h = slider->width;
+			}
+			else {	
+				rect.x = slider->x + (slider->length - slider->width) * slider->value;
+				rect.y = slider->y - slider->width;
+				rect.w = slider->width;
+				rect.h = slider->width * 3;
+			}
 
-				if(GUI_IsPointInsideRect(event.button.x, event.button.y, rect.x, rect.y, rect.w, rect.h)) {
-					handled = true;
-					slider->holding = true;
-					GUI_TriggerEvents(context, slider, GUI_SLIDER_ON_HOLD);
+			if(GUI_InternalHitTest(context, node, event.button.x, event.button.y, rect.x, rect.y, rect.w, rect.h)) {
+				handled = true;
+				slider->holding = true;
+				GUI_InternalTriggerNode(context, node, GUI_SLIDER_ON_HOLD);
+			}
+		}
+		else if(event.type == SDL_MOUSEBUTTONUP) {
+			if(slider->inc != NULL && slider->dec != NULL && GUI_InternalHitTest(context, node, event.button.x, event.button.y, slider->dec->x, slider->dec->y, slider->dec->width, slider->dec->height)) {
+				handled = true;
+				slider->value -= slider->buttonValueMod;
+				if(slider->value < 0.0) {
+					slider->value = 0.0;
 				}
 			}
-			else if(event.type == SDL_MOUSEBUTTONUP) {
-				if(slider->inc != NULL && slider->dec != NULL && GUI_IsPointInsideRect(event.button.x, event.button.y, slider->dec->x, slider->dec->y, slider->dec->width, slider->dec->height)) {
-					handled = true;
-					slider->value -= slider->buttonValueMod;
-					if(slider->value < 0.0) {
-						slider->value = 0.0;
-					}
+			else if(slider->inc != NULL && slider->dec != NULL && GUI_InternalHitTest(context, node, event.button.x, event.button.y, slider->inc->x, slider->inc->y, slider->inc->width, slider->inc->height)) {
+				handled = true;
+				slider->value += slider->buttonValueMod;
+				if(slider->value > 1.0) {
+					slider->value = 1.0;
 				}
-				else if(slider->inc != NULL && slider->dec != NULL && GUI_IsPointInsideRect(event.button.x, event.button.y, slider->inc->x, slider->inc->y, slider->inc->width, slider->inc->height)) {
-					handled = true;
-					slider->value += slider->buttonValueMod;
-					if(slider->value > 1.0) {
-						slider->value = 1.0;
-					}
+			}
+			else if(slider->holding) {
+				handled = true;
+				slider->holding = false;
+				GUI_InternalTriggerNode(context, node, GUI_SLIDER_ON_RELEASE);
+			}
+		}
+		else if(event.type == SDL_MOUSEMOTION && slider->holding) {
+			handled = true;
+			GUI_InternalTriggerNode(context, node, GUI_SLIDER_INTERNAL);
+		}
+
+		GUI_InternalSetActive(context, node, slider->holding);
+		if(slider->value != previous)
+			GUI_InternalSliderChanged(context, node);
+	}
+	else if(node->type == GUI_COMPONENT_LIST_VIEW) {
+		GUI_ListView *list = (GUI_ListView*) node->component;
+
+		if(event.type == SDL_MOUSEMOTION) {
+			list->inside = GUI_InternalHitTest(context, node, event.motion.x, event.motion.y, list->x, list->y, list->width, list->height);
+		}
+		else if(event.type == SDL_MOUSEBUTTONDOWN) {
+			if(GUI_InternalHitTest(context, node, event.button.x, event.button.y, list->x, list->y, list->width, list->height)) {
+				int row = (event.button.y - list->y + list->scroll) / list->rowHeight;
+				handled = true;
+
+				if(row < list->numRows && row != list->selected) {
+					list->selected = row;
+					GUI_InternalTriggerNode(context, node, GUI_LIST_VIEW_ON_SELECT);
 				}
-				else if(slider->holding) {
-					handled = true;
-					slider->holding = false;
-					GUI_TriggerEvents(context, slider, GUI_SLIDER_ON_RELEASE);
+			}
+		}
+		else if(event.type == SDL_MOUSEWHEEL && list->inside) {
+			int scroll = list->scroll;
+			int lines = event.wheel.direction == SDL_MOUSEWHEEL_FLIPPED ? -event.wheel.y : event.wheel.y;
+
+			GUI_ScrollListView(context, list, list->scroll - lines * list->rowHeight * GUI_LIST_VIEW_WHEEL_ROWS);
+			handled = list->scroll != scroll;
+		}
+
+		GUI_InternalSetActive(context, node, list->inside);
+	}
+
+	if(handled)
+		GUI_InternalMarkNodeDirty(context, node);
+
+	return handled;
+}
+static bool GUI_InternalPostCommand(GUI_Context *context, GUI_CommandType type, void *component, float value, const char *str, bool hidden) {
+	GUI_Command *command = (GUI_Command*) malloc(sizeof(GUI_Command));
+	if(command == NULL)
+		return true;
+
+	command->type = type;
+	command->component = component;
+	command->value = value;
+	command->str = NULL;
+	command->hidden = hidden;
+
+	if(str != NULL) {
+		command->str = (char*) malloc(strlen(str) + 1);
+		if(command->str == NULL) {
+			free(command);
+			return true;
+		}
+		strcpy(command->str, str);
+	}
+
+	GUI_InternalQueuePush(&context->commands, command);
+
+	// only the first command since the last drain wakes up the event loop
+	if(context->commands.eventType != (Uint32) -1 && SDL_AtomicCAS(&context->commands.wake, 0, 1)) {
+		SDL_Event event;
+		memset(&event, 0, sizeof(SDL_Event));
+		event.type = context->commands.eventType;
+		SDL_PushEvent(&event);
+	}
+
+	return false;
+}
+static bool GUI_InternalDrainCommands(GUI_Context *context) {
+	GUI_CommandQueue *queue = &context->commands;
+	GUI_Command *command;
+
+	SDL_AtomicSet(&queue->wake, 0);
+	queue->numDrained = 0;
+	while((command = GUI_InternalQueuePop(queue)) != NULL) {
+		if(queue->numDrained >= queue->drainedCapacity && GUI_InternalReserve((void**) &queue->drained, &queue->drainedCapacity, queue->numDrained + 1, sizeof(GUI_Command*))) {
+			GUI_InternalFreeCommand(command);
+			continue;
+		}
+
+		queue->drained[queue->numDrained++] = command;
+	}
+
+	if(queue->numDrained == 0)
+		return false;
+
+	// walked backwards so only the last command of each kind for a component is applied
+	queue->drainCount++;
+	for(int i = queue->numDrained - 1; i >= 0; i--) {
+		command = queue->drained[i];
+		GUI_ComponentNode *node = GUI_FindComponent(context, command->component);
+
+		if(node != NULL && node->commandDrain != queue->drainCount) {
+			node->commandDrain = queue->drainCount;
+			node->commandMask = 0;
+		}
+
+		if(node != NULL && !(node->commandMask & (1 << command->type))) {
+			node->commandMask |= 1 << command->type;
+
+			if(command->type == GUI_COMMAND_SLIDER_VALUE && node->type == GUI_COMPONENT_SLIDER)
+				GUI_SetSliderValue(context, (GUI_Slider*) node->component, command->value);
+			else if(command->type == GUI_COMMAND_TEXT && node->type == GUI_COMPONENT_TEXT)
+				GUI_SetText(context, (GUI_Text*) node->component, command->str);
+			else if(command->type == GUI_COMMAND_HIDDEN)
+				GUI_SetHidden(context, node->component, command->hidden);
+		}
+
+		GUI_InternalFreeCommand(command);
+	}
+
+	queue->numDrained = 0;
+	return true;
+}
+bool GUI_PostSliderValue(GUI_Context *context, GUI_Slider *slider, float value) {
+	return GUI_InternalPostCommand(context, GUI_COMMAND_SLIDER_VALUE, slider, value, NULL, false);
+}
+bool GUI_PostText(GUI_Context *context, GUI_Text *text, const char *str) {
+	if(str == NULL)
+		return true;
+
+	return GUI_InternalPostCommand(context, GUI_COMMAND_TEXT, text, 0, str, false);
+}
+bool GUI_PostHidden(GUI_Context *context, void *component, bool hidden) {
+	return GUI_InternalPostCommand(context, GUI_COMMAND_HIDDEN, component, 0, NULL, hidden);
+}
+
+static bool GUI_InternalUpdateEvent(GUI_Context *context, const SDL_Event *event) {
+	bool handled = false;
+	GUI_GridCell *cell = NULL;
+	int x = 0, y = 0;
+	context->updateCount++;
+
+	if(event->type == SDL_WINDOWEVENT && event->window.event == SDL_WINDOWEVENT_SIZE_CHANGED && event->window.windowID == SDL_GetWindowID(context->window)) {
+		GUI_InternalResize(context, event->window.data1, event->window.data2);
+	}
+	else if(event->type == SDL_MOUSEMOTION) {
+		x = event->motion.x;
+		y = event->motion.y;
+		cell = GUI_GridCellAt(&context->grid, x, y);
+	}
+	else if(event->type == SDL_MOUSEBUTTONDOWN || event->type == SDL_MOUSEBUTTONUP) {
+		x = event->button.x;
+		y = event->button.y;
+		cell = GUI_GridCellAt(&context->grid, x, y);
+	}
+
+	// the wheel goes to whatever the pointer is over, which is always in the active list
+	if(cell != NULL || event->type == SDL_MOUSEWHEEL) {
+		GUI_HotStore *hot = &context->hot;
+		if(cell != NULL && cell->stale && GUI_HotPackCell(hot, cell))
+			cell = NULL;
+
+		// components away from the pointer can only react if they're active, and then they're updated below.
+		// Callbacks can change the cell, but anything they move is hit-tested again when it's updated.
+		int packedCount = cell != NULL ? cell->count : 0;
+		const int *packed = cell != NULL ? cell->packed : NULL;
+
+		for(int start = 0; start < packedCount; start += GUI_HIT_CHUNK) {
+			Uint32 mask[GUI_HIT_CHUNK / 32];
+			int count = SDL_min(packedCount - start, GUI_HIT_CHUNK);
+			const int *x0 = packed + start;
+
+			GUI_HitTestRects(x, y, x0, x0 + packedCount, x0 + packedCount * 2, x0 + packedCount * 3, count, mask);
+
+			for(int word = 0; word < (count + 31) / 32; word++) {
+				for(Uint32 bits = mask[word]; bits != 0; bits &= bits - 1) {
+					int i = start + word * 32 + GUI_InternalLowestBit(bits);
+					if(i >= cell->count || cell->items[i] >= hot->count)
+						continue;
+
+					int index = cell->items[i];
+					if(hot->visited[index] == context->updateCount || !(hot->flags[index] & (GUI_HOT_ON_SCREEN | GUI_HOT_RETAINED)))
+						continue;
+
+					if(GUI_InternalUpdateComponent(context, hot->nodes[index], *event))
+						handled = true;
 				}
 			}
-			else if(event.type == SDL_MOUSEMOTION && slider->holding) {
+		}
+
+		// walked backwards because leaving the active list swaps the last entry into the freed slot
+		for(int i = context->numActive - 1; i >= 0; i--) {
+			if(i < context->numActive && hot->visited[context->active[i]->hotIndex] != context->updateCount && GUI_InternalUpdateComponent(context, context->active[i], *event))
 				handled = true;
-				GUI_TriggerEvents(context, slider, GUI_SLIDER_INTERNAL);
+		}
+	}
+
+	return handled;
+}
+// Posted commands and loaded images are applied whatever the event was, so they're reported through
+// GUI_NeedsFrame rather than the result, which only says whether the event itself was handled.
+static void GUI_InternalDrainPending(GUI_Context *context) {
+	if(GUI_InternalDrainCommands(context))
+		context->redraw = true;
+	if(context->loader.lock != NULL && GUI_InternalDrainLoader(context))
+		context->redraw = true;
+}
+// the events pushed to wake a waiting loop belong to the library, and are handled by draining
+static bool GUI_InternalIsWakeEvent(GUI_Context *context, const SDL_Event *event) {
+	return event->type == context->commands.eventType || (context->loader.lock != NULL && event->type == context->loader.eventType);
+}
+bool GUI_Update(GUI_Context *context, SDL_Event event) {
+	GUI_InternalDrainPending(context);
+	bool handled = GUI_InternalIsWakeEvent(context, &event) || GUI_InternalUpdateEvent(context, &event);
+
+	GUI_InternalClearDrawn(context);
+	return handled;
+}
+bool GUI_UpdateBatch(GUI_Context *context, const SDL_Event *events, int count, bool *results) {
+	bool handled = false;
+
+	GUI_InternalDrainPending(context);
+
+	for(int i = 0; i < count; i++) {
+		// a run of motion events only needs its last position, and the whole run shares its result
+		int last = i;
+		if(events[i].type == SDL_MOUSEMOTION) {
+			while(last + 1 < count && events[last + 1].type == SDL_MOUSEMOTION) {
+				last++;
 			}
 		}
 
-		next:
-		compNode = compNode->next;
+		bool result = GUI_InternalIsWakeEvent(context, &events[last]) || GUI_InternalUpdateEvent(context, &events[last]);
+		if(result)
+			handled = true;
+
+		if(results != NULL) {
+			for(int j = i; j <= last; j++) {
+				results[j] = result;
+			}
+		}
+		i = last;
 	}
 
+	GUI_InternalClearDrawn(context);
 	return handled;
 }
+
+// Only blocks while no frame is due, so an idle UI sleeps in SDL_WaitEvent until input, a posted command,
+// a loaded image or a timer event arrives. Events are handled as they come, but the drawn list is only
+// cleared once a new frame is due, since until then the last frame is still what's on screen.
+bool GUI_WaitAndUpdate(GUI_Context *context, SDL_Event *event, int timeout) {
+	while(true) {
+		int received;
+
+		if(GUI_NeedsFrame(context))
+			received = SDL_PollEvent(event);
+		else if(timeout < 0)
+			received = SDL_WaitEvent(event);
+		else
+			received = SDL_WaitEventTimeout(event, timeout);
+
+		GUI_InternalDrainPending(context);
+
+		if(!received) {
+			if(GUI_NeedsFrame(context))
+				GUI_InternalClearDrawn(context);
+
+			return false;
+		}
+
+		if(GUI_InternalIsWakeEvent(context, event))
+			continue;
+
+		bool handled = GUI_InternalUpdateEvent(context, event);
+		if(event->type == SDL_WINDOWEVENT && (event->window.event == SDL_WINDOWEVENT_EXPOSED || event->window.event == SDL_WINDOWEVENT_SIZE_CHANGED)) {
+			context->redraw = true;
+		}
+		else if(handled) {
+			context->redraw = true;
+			continue;
+		}
+
+		return true;
+	}
+}
+bool GUI_NeedsFrame(GUI_Context *context) {
+	return context->redraw || context->animating;
+}
+void GUI_RequestRedraw(GUI_Context *context) {
+	context->redraw = true;
+}
+void GUI_FrameDone(GUI_Context *context) {
+	context->redraw = false;
+}
+void GUI_SetAnimating(GUI_Context *context, bool animating) {
+	context->animating = animating;
+}
+bool GUI_Run(GUI_Context *context, GUI_EventHandler onEvent, GUI_DrawHandler onDraw, void *data) {
+	SDL_Event event;
+
+	while(true) {
+		while(GUI_WaitAndUpdate(context, &event, -1)) {
+			// without a handler nothing else could end the loop, so it ends when the window is closed
+			if(onEvent == NULL ? event.type == SDL_QUIT : onEvent(&event, data))
+				return false;
+		}
+
+		// waiting forever only comes back empty when SDL_WaitEvent failed, and trying again would spin
+		if(!GUI_NeedsFrame(context))
+			return true;
+
+		if(onDraw != NULL)
+			onDraw(data);
+		GUI_Flush(context);
+		SDL_RenderPresent(context->render);
+		GUI_FrameDone(context);
+	}
+}
@@ -19,7 +19,11 @@
 #define COLOR_WHITE (SDL_Color) {0xff, 0xff, 0xff, 0xff}
 
 typedef int GUI_FontID;
+typedef int GUI_PackID;
 typedef void (*GUI_Event)(void* component);
+typedef bool (*GUI_EventHandler)(SDL_Event *event, void *data);
+typedef void (*GUI_DrawHandler)(void *data);
+typedef const char* (*GUI_ListViewSource)(int row, void *data);
 
 typedef enum {
 	GUI_BUTTON_ON_PRESS,
@@ -28,51 +32,305 @@ typedef enum {
 	GUI_BUTTON_ON_EXIT,
 	GUI_SLIDER_INTERNAL,
 	GUI_SLIDER_ON_HOLD,
-	GUI_SLIDER_ON_RELEASE
+	GUI_SLIDER_ON_RELEASE,
+	GUI_IMAGE_ON_LOAD,
+	GUI_IMAGE_ON_FAIL,
+	GUI_SLIDER_ON_CHANGE,
+	GUI_LIST_VIEW_ON_SELECT
 } GUI_EventType;
 
-struct _GUI_EventNode {
-	GUI_Event event;
-	GUI_EventType type;
-	struct _GUI_EventNode *prev;
-	struct _GUI_EventNode *next;
-};
-typedef struct _GUI_EventNode GUI_EventNode;
+#define GUI_EVENT_INLINE_CAPACITY 2
+#define GUI_EVENT_BUCKETS 4
+
+typedef struct {
+	GUI_Event *events;
+	int count, capacity;
+	GUI_Event inlineEvents[GUI_EVENT_INLINE_CAPACITY];
+} GUI_EventList;
 
 typedef enum {
 	GUI_COMPONENT_TEXT,
 	GUI_COMPONENT_IMAGE,
 	GUI_COMPONENT_BUTTON,
-	GUI_COMPONENT_SLIDER
+	GUI_COMPONENT_SLIDER,
+	GUI_COMPONENT_CONTAINER,
+	GUI_COMPONENT_LIST_VIEW
 } GUI_ComponentType;
 
 struct _GUI_ComponentNode {
 	void* component;
 	GUI_ComponentType type;
-	GUI_EventNode *events;
+	GUI_EventList events[GUI_EVENT_BUCKETS];
+
+	int gridX0, gridY0, gridX1, gridY1;
+	int activeIndex;
+	int hotIndex;
+
+	int x, y;
+	SDL_Rect bounds;
+	bool placed;
+
+	bool hidden;
+	unsigned int commandDrain;
+	Uint8 commandMask;
 
+	int numOwners;
+	struct _GUI_ComponentNode *owner;
+	struct _GUI_ComponentNode *parent;
 	struct _GUI_ComponentNode *prev;
 	struct _GUI_ComponentNode *next;
 };
 typedef struct _GUI_ComponentNode GUI_ComponentNode;
 
+typedef struct {
+	size_t itemSize;
+	int itemsPerSlab;
+	void *slabs;
+	void *freeList;
+	int numSlabs, numUsed;
+} GUI_Pool;
+
+typedef struct {
+	int *items;
+	int count, capacity;
+
+	int *packed;
+	int packedCapacity;
+	bool stale;
+} GUI_GridCell;
+
+typedef struct {
+	GUI_GridCell *cells;
+	int columns, rows, cellSize;
+} GUI_Grid;
+
+#define GUI_HOT_ON_SCREEN 0x01
+#define GUI_HOT_RETAINED 0x02
+
+typedef struct {
+	GUI_ComponentNode **nodes;
+	int *x0, *y0, *x1, *y1;
+	Uint8 *flags;
+	unsigned int *visited;
+	int count, capacity;
+} GUI_HotStore;
+
+#define GUI_ATLAS_SIZE 512
+#define GUI_ATLAS_GLYPHS 256
+
+typedef struct {
+	SDL_Texture *texture;
+	int width, height;
+	int shelfX, shelfY, shelfHeight;
+	int numImages;
+} GUI_AtlasPage;
+
+typedef struct {
+	SDL_Rect rect;
+	int page, advance;
+	bool loaded;
+} GUI_Glyph;
+
+typedef struct {
+	GUI_Glyph glyphs[GUI_ATLAS_GLYPHS];
+	GUI_AtlasPage *pages;
+	int numPages, height, lineSkip;
+
+	char *path;
+	int ptsize;
+} GUI_GlyphAtlas;
+
+#define GUI_BAKED_FONT_VERSION 1
+#define GUI_BAKED_FIRST_GLYPH 32
+#define GUI_BAKED_LAST_GLYPH 126
+
+#define GUI_TEXT_CACHE_DEFAULT_BUDGET (8 * 1024 * 1024)
+
+struct _GUI_TextCacheEntry {
+	char *str;
+	GUI_FontID font;
+	SDL_Color fg, bg;
+	bool shaded;
+	Uint32 hash;
+
+	SDL_Texture *texture;
+	int width, height;
+	size_t bytes;
+	int refCount;
+
+	struct _GUI_TextCacheEntry *hashNext;
+	struct _GUI_TextCacheEntry *lruPrev, *lruNext;
+};
+typedef struct _GUI_TextCacheEntry GUI_TextCacheEntry;
+
+typedef struct {
+	GUI_TextCacheEntry **buckets;
+	int numBuckets, numEntries;
+	GUI_TextCacheEntry *lruHead, *lruTail;
+	size_t bytes, budget;
+	int hits, misses, evictions;
+} GUI_TextCache;
+
+struct _GUI_ImageCacheEntry {
+	char *path;
+	Uint32 hash;
+
+	SDL_Texture *texture;
+	SDL_Rect src;
+	int page;
+	int refCount;
+
+	struct _GUI_ImageCacheEntry *hashNext;
+};
+typedef struct _GUI_ImageCacheEntry GUI_ImageCacheEntry;
+
+typedef struct {
+	GUI_ImageCacheEntry **buckets;
+	int numBuckets, numEntries;
+	int hits, misses;
+} GUI_ImageCache;
+
+#define GUI_LOADER_MAX_THREADS 4
+
+struct _GUI_ImageJob {
+	char *path;
+	float xScale, yScale;
+	void *image;
+	SDL_Surface *surface;
+	struct _GUI_ImageJob *next;
+};
+typedef struct _GUI_ImageJob GUI_ImageJob;
+
+typedef struct {
+	SDL_Thread *threads[GUI_LOADER_MAX_THREADS];
+	int numThreads;
+	SDL_mutex *lock;
+	SDL_cond *wake;
+	GUI_ImageJob *pending, *pendingTail, *done;
+	Uint32 eventType;
+	bool quit;
+} GUI_ImageLoader;
+
+typedef enum {
+	GUI_COMMAND_SLIDER_VALUE,
+	GUI_COMMAND_TEXT,
+	GUI_COMMAND_HIDDEN
+} GUI_CommandType;
+
+struct _GUI_Command {
+	struct _GUI_Command *next;
+	GUI_CommandType type;
+	void *component;
+	float value;
+	char *str;
+	bool hidden;
+};
+typedef struct _GUI_Command GUI_Command;
+
+typedef struct {
+	GUI_Command *head, *tail;
+	GUI_Command stub;
+	SDL_atomic_t wake;
+	Uint32 eventType;
+	unsigned int drainCount;
+
+	GUI_Command **drained;
+	int numDrained, drainedCapacity;
+} GUI_CommandQueue;
+
+#define GUI_PACK_VERSION 1
+
+typedef struct {
+	char *path;
+	const Uint8 *data;
+	size_t size;
+	Uint32 count;
+	void *file, *mapping;
+} GUI_Pack;
+
+typedef struct {
+	SDL_Texture *texture;
+	int first, count;
+} GUI_DrawCommand;
+
+typedef struct {
+	GUI_DrawCommand *commands;
+	SDL_Vertex *vertices;
+	int *indices;
+	int numCommands, commandsCapacity, numVertices, verticesCapacity, numIndices, indicesCapacity;
+	bool batching;
+} GUI_DrawList;
+
+typedef struct {
+	int renderCalls, textureBinds;
+	int componentsVisited, hitTests;
+	int callbacks;
+	Uint64 callbackTicks;
+	int texturesCreated, texturesDestroyed;
+	int layoutVisits;
+} GUI_FrameStats;
+
 typedef struct {
 	SDL_Window *window;
 	SDL_Renderer *render;
 	int width, height;
-	GUI_ComponentNode *components;
+	GUI_ComponentNode *components, *componentsTail;
+	GUI_Pool componentPool;
+	GUI_ComponentNode **registry;
+	int registryCapacity, registryCount;
+	GUI_Grid grid;
+	GUI_HotStore hot;
+	int *drawn;
+	GUI_ComponentNode **active;
+	int numDrawn, drawnCapacity, numActive, activeCapacity;
+	unsigned int updateCount;
 	TTF_Font **fonts;
+	GUI_GlyphAtlas *atlases;
 	int numFonts;
+	GUI_TextCache textCache;
+	GUI_DrawList drawList;
+
+	SDL_Texture *frame;
+	int frameWidth, frameHeight;
+	SDL_Rect dirtyRect;
+	bool dirty, directDraw;
+
+	GUI_AtlasPage *imagePages;
+	int numImagePages;
+	bool imageAtlas;
+	GUI_ImageLoader loader;
+	GUI_ImageCache imageCache;
+	GUI_Pack *packs;
+	int numPacks;
+	GUI_CommandQueue commands;
+	GUI_FrameStats stats;
+	bool redraw, animating;
+
+	GUI_ComponentNode *root;
+	GUI_ComponentNode **layoutRoots;
+	int numLayoutRoots, layoutRootsCapacity;
+	bool layoutDirty;
 } GUI_Context;
 
 typedef struct {
 	SDL_Texture* texture;
 	int width, height;
+	GUI_TextCacheEntry *cacheEntry;
+
+	char *str;
+	GUI_FontID font;
+	SDL_Color fg, bg;
+	bool shaded;
+	int textureWidth, textureHeight;
 } GUI_Text;
 
 typedef struct {
 	SDL_Texture* texture;
 	int width, height;
+	SDL_Rect src;
+	int page;
+	GUI_ImageCacheEntry *cacheEntry;
+	GUI_ImageJob *job;
 } GUI_Image;
 
 typedef struct {
@@ -81,33 +339,126 @@ typedef struct {
 	int x, y, width, height;
 	int borderWidth;
 	SDL_Color fillColor, borderColor;
-	bool inside, pressed, onScreen;
+	bool inside, pressed;
 } GUI_Button;
 
+typedef struct {
+	SDL_atomic_t value;
+	float current, target, step;
+	int rampSamples, remaining;
+} GUI_SliderParam;
+
 typedef struct {
 	GUI_Button *inc, *dec;
 	int x, y, width, length;
 	bool vertical;
 	SDL_Color sliderColor, handleColor;
 	float value, buttonValueMod;
-	bool holding, onScreen;
+	bool holding;
+	GUI_SliderParam *param;
+	GUI_ComponentNode *target;
 } GUI_Slider;
 
+typedef enum {
+	GUI_LAYOUT_HSTACK,
+	GUI_LAYOUT_VSTACK,
+	GUI_LAYOUT_GRID,
+	GUI_LAYOUT_ANCHOR
+} GUI_LayoutType;
+
+typedef enum {
+	GUI_ANCHOR_TOP_LEFT,
+	GUI_ANCHOR_TOP,
+	GUI_ANCHOR_TOP_RIGHT,
+	GUI_ANCHOR_LEFT,
+	GUI_ANCHOR_CENTER,
+	GUI_ANCHOR_RIGHT,
+	GUI_ANCHOR_BOTTOM_LEFT,
+	GUI_ANCHOR_BOTTOM,
+	GUI_ANCHOR_BOTTOM_RIGHT
+} GUI_Anchor;
+
+typedef struct {
+	GUI_ComponentNode *node;
+	GUI_Anchor anchor;
+	int offsetX, offsetY;
+} GUI_LayoutChild;
+
+typedef struct {
+	GUI_LayoutType layout;
+	int width, height;
+	int padding, spacing, columns;
+	GUI_LayoutChild *children;
+	int numChildren, childrenCapacity;
+
+	int measuredWidth, measuredHeight, cellWidth, cellHeight;
+	SDL_Rect rect;
+	bool measureValid, arrangeValid;
+
+	bool clip;
+	int scrollX, scrollY, contentWidth, contentHeight;
+	GUI_Slider *hSlider, *vSlider;
+} GUI_Container;
+
+typedef struct {
+	GUI_ListViewSource source;
+	void *data;
+	int numRows, rowHeight;
+	int x, y, width, height;
+	GUI_FontID font;
+	SDL_Color fg, fillColor, selectedColor;
+	GUI_Slider *slider;
+	int scroll, selected;
+
+	GUI_Text **rows;
+	int *rowIndices;
+	int numPooled;
+	bool inside;
+} GUI_ListView;
+
 GUI_Context* GUI_Init(SDL_Window *win, SDL_Renderer *render);
 void GUI_Quit(GUI_Context *context);
 
-void GUI_SerializeComponent(GUI_Context *context, void *component, GUI_ComponentType type);
+void GUI_GetFrameStats(GUI_Context *context, GUI_FrameStats *stats);
+
+void GUI_SetBatching(GUI_Context *context, bool batching);
+void GUI_Flush(GUI_Context *context);
+
+void GUI_Place(GUI_Context *context, void *component, int x, int y);
+void GUI_Unplace(GUI_Context *context, void *component);
+void GUI_MarkDirty(GUI_Context *context, void *component);
+bool GUI_NeedsRedraw(GUI_Context *context);
+void GUI_Render(GUI_Context *context);
+
+bool GUI_SerializeComponent(GUI_Context *context, void *component, GUI_ComponentType type);
 void GUI_FreeComponent(GUI_Context *context, void *component);
+GUI_ComponentNode* GUI_FindComponent(GUI_Context *context, void *component);
+void GUI_SetHidden(GUI_Context *context, void *component, bool hidden);
+bool GUI_PostSliderValue(GUI_Context *context, GUI_Slider *slider, float value);
+bool GUI_PostText(GUI_Context *context, GUI_Text *text, const char *str);
+bool GUI_PostHidden(GUI_Context *context, void *component, bool hidden);
 GUI_FontID GUI_NewFont(GUI_Context *context, const char *path, int ptsize);
+GUI_FontID GUI_NewFontFromPack(GUI_Context *context, GUI_PackID pack, const char *name, int ptsize);
+GUI_PackID GUI_OpenPack(GUI_Context *context, const char *path);
+bool GUI_BakeFont(GUI_Context *context, GUI_FontID font, const char *path);
+GUI_FontID GUI_NewBakedFont(GUI_Context *context, const char *bakedPath, const char *fontPath, int ptsize);
 
 GUI_Text* GUI_NewTextBg(GUI_Context *context, GUI_FontID font, const char *str, SDL_Color fg, SDL_Color bg);
 GUI_Text* GUI_NewText(GUI_Context *context, GUI_FontID font, const char *str, SDL_Color fg);
 void GUI_FreeText(GUI_Context *context, GUI_Text *text);
+bool GUI_SetText(GUI_Context *context, GUI_Text *text, const char *str);
+void GUI_SetTextCacheBudget(GUI_Context *context, size_t bytes);
 void GUI_DrawText(GUI_Context *context, GUI_Text *text, int x, int y);
 
+void GUI_DrawString(GUI_Context *context, GUI_FontID font, const char *str, SDL_Color color, int x, int y);
+void GUI_SizeString(GUI_Context *context, GUI_FontID font, const char *str, int *width, int *height);
+
 GUI_Image* GUI_NewImage(GUI_Context *context, const char *path, float xScale, float yScale); 
+GUI_Image* GUI_NewImageAsync(GUI_Context *context, const char *path, float xScale, float yScale);
+GUI_Image* GUI_NewImageFromPack(GUI_Context *context, GUI_PackID pack, const char *name, float xScale, float yScale);
 void GUI_FreeImage(GUI_Context *context, GUI_Image *image);
 void GUI_DrawImage(GUI_Context *context, GUI_Image *image, int x, int y);
+void GUI_SetImageAtlas(GUI_Context *context, bool enabled);
 
 GUI_Button* GUI_NewButton(GUI_Context *context, int width, int height, int borderWidth, SDL_Color fillColor, SDL_Color borderColor, GUI_Text *textContent, GUI_Image *imageContent);
 void GUI_FreeButton(GUI_Context *context, GUI_Button *button);
@@ -115,14 +466,46 @@ void GUI_DrawButton(GUI_Context *context, GUI_Button *button, int x, int y);
 
 GUI_Slider* GUI_NewSlider(GUI_Context *context, GUI_Button *incrementButton, GUI_Button *decrementButton, float buttonValueMod, int width, int length, bool vertical, SDL_Color sliderColor, SDL_Color handleColor);
 void GUI_FreeSlider(GUI_Context *context, GUI_Slider *slider);
+void GUI_SetSliderValue(GUI_Context *context, GUI_Slider *slider, float value);
+void GUI_SetSliderParam(GUI_Slider *slider, GUI_SliderParam *param);
+void GUI_InitSliderParam(GUI_SliderParam *param, float value, int rampSamples);
+float GUI_ReadSliderParam(GUI_SliderParam *param);
+float GUI_NextSliderSample(GUI_SliderParam *param);
 void GUI_DrawSlider(GUI_Context *context, GUI_Slider *slider, int x, int y);
 
+GUI_Container* GUI_NewContainer(GUI_Context *context, GUI_LayoutType layout, int width, int height, int padding, int spacing, int columns);
+void GUI_FreeContainer(GUI_Context *context, GUI_Container *container);
+bool GUI_AddChild(GUI_Context *context, GUI_Container *container, void *component);
+bool GUI_AddAnchoredChild(GUI_Context *context, GUI_Container *container, void *component, GUI_Anchor anchor, int offsetX, int offsetY);
+bool GUI_RemoveChild(GUI_Context *context, GUI_Container *container, void *component);
+void GUI_SetContainerSize(GUI_Context *context, GUI_Container *container, int width, int height);
+void GUI_SetRootContainer(GUI_Context *context, GUI_Container *container);
+void GUI_InvalidateLayout(GUI_Context *context, void *component);
+void GUI_DrawContainer(GUI_Context *context, GUI_Container *container, int x, int y);
+GUI_Container* GUI_NewScrollPanel(GUI_Context *context, GUI_LayoutType layout, int width, int height, int padding, int spacing, int columns);
+void GUI_ScrollContainer(GUI_Context *context, GUI_Container *container, int scrollX, int scrollY);
+void GUI_SetScrollSlider(GUI_Context *context, GUI_Container *container, GUI_Slider *slider);
+
+GUI_ListView* GUI_NewListView(GUI_Context *context, GUI_ListViewSource source, void *data, int numRows, int rowHeight, int width, int height, GUI_FontID font, SDL_Color fg, SDL_Color fillColor, SDL_Color selectedColor, GUI_Slider *slider);
+void GUI_FreeListView(GUI_Context *context, GUI_ListView *list);
+void GUI_SetListViewRows(GUI_Context *context, GUI_ListView *list, int numRows);
+void GUI_ScrollListView(GUI_Context *context, GUI_ListView *list, int scroll);
+void GUI_DrawListView(GUI_Context *context, GUI_ListView *list, int x, int y);
+
 bool GUI_IsPointInsideRect(int mx, int my, int x, int y, int w, int h);
+void GUI_HitTestRects(int mx, int my, const int *x0, const int *y0, const int *x1, const int *y1, int count, Uint32 *mask);
 
 bool GUI_AddEvent(GUI_Context *context, void *component, GUI_Event event, GUI_EventType type);
 bool GUI_ClearEvents(GUI_Context *context, void *component);
 bool GUI_RemoveEvent(GUI_Context *context, void *component, GUI_Event event, GUI_EventType type);
 bool GUI_TriggerEvents(GUI_Context *context, void *component, GUI_EventType type);
 bool GUI_Update(GUI_Context *context, SDL_Event event);
+bool GUI_UpdateBatch(GUI_Context *context, const SDL_Event *events, int count, bool *results);
+bool GUI_WaitAndUpdate(GUI_Context *context, SDL_Event *event, int timeout);
+bool GUI_NeedsFrame(GUI_Context *context);
+void GUI_RequestRedraw(GUI_Context *context);
+void GUI_FrameDone(GUI_Context *context);
+void GUI_SetAnimating(GUI_Context *context, bool animating);
+bool GUI_Run(GUI_Context *context, GUI_EventHandler onEvent, GUI_DrawHandler onDraw, void *data);
 
 #endif